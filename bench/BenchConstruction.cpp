@@ -0,0 +1,149 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <lb/options/Options.h>
+#include <lb/options/Snapshot.h>
+
+
+namespace
+{
+
+
+// A typical tool's worth of options.
+lb::options::Options<int> makeOptions( const lb::options::Options<int>::Configuration& config )
+{
+  return
+  {
+    {
+      { 0 , 'h' , "help"         , 0 , 0, "Show this help." },
+      { 1 , 'v' , "verbose"      , 0 , 0, "Say more about what is going on." },
+      { 2 , 'q' , "quiet"        , 0 , 0, "Say less about what is going on." },
+      { 3 , 'o' , "output"       , 1 , 1, "Where to write the results.", { "-" } },
+      { 4 , 'i' , "input"        , 1 , -1, "The files to read." },
+      { 5 , 'j' , "jobs"         , 1 , 1, "How many jobs to run at once.", { "1" } },
+      { 6 , 'c' , "config"       , 1 , 1, "A configuration file to read first." },
+      { 7 , '\0', "log-level"    , 1 , 1, "How much to log.", { "warning" } },
+      { 8 , '\0', "log-file"     , 1 , 1, "Where to log to." },
+      { 9 , '\0', "dry-run"      , 0 , 0, "Do everything but write the results." },
+      { 10, 'f' , "force"        , 0 , 0, "Overwrite existing results." },
+      { 11, '\0', "timeout"      , 1 , 1, "Give up after this many seconds.", { "30" } },
+      { 12, '\0', "retries"      , 1 , 1, "Try this many times.", { "3" } },
+      { 13, 'I' , "include"      , 1 , 1, "Add a directory to search." },
+      { 14, 'D' , "define"       , 1 , 1, "Define a variable." },
+      { 15, '\0', "color"        , 0 , 1, "Colour the output.", { "auto" } },
+    }
+  , config };
+}
+
+
+void BM_ConstructOptions( benchmark::State& state )
+{
+  typename lb::options::Options<int>::Configuration config;
+  config.allowAbbreviations = state.range( 0 ) & 1;
+  config.usePerfectHash = state.range( 0 ) & 2;
+
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( makeOptions( config ) );
+  }
+}
+// Default configuration, abbreviations, perfect hashes, both.
+BENCHMARK( BM_ConstructOptions )->DenseRange( 0, 3 );
+
+
+std::vector<std::string> makeFlags( std::size_t count )
+{
+  std::vector<std::string> flags;
+  flags.reserve( count );
+  for ( std::size_t i = 0; i < count; ++i )
+  {
+    flags.push_back( "group" + std::to_string( i / 20 ) + ".setting" + std::to_string( i % 20 ) );
+  }
+  return flags;
+}
+
+
+std::vector< lb::options::KeyedOptionDefinition<int> > makeDefinitions( std::size_t count )
+{
+  const auto flags{ makeFlags( count ) };
+  std::vector< lb::options::KeyedOptionDefinition<int> > definitions;
+  definitions.reserve( count );
+  for ( std::size_t i = 0; i < count; ++i )
+  {
+    definitions.push_back( { static_cast<int>( i ), '\0', flags[i], 1, 1
+                           , "The setting called " + flags[i] + " which is described at some length."
+                           , { "default-for-" + flags[i] } } );
+  }
+  return definitions;
+}
+
+
+// Whole construction from definitions built at run time, copied from a range
+// or moved in as a vector.
+void BM_ConstructFromDefinitions( benchmark::State& state )
+{
+  const auto definitions{ makeDefinitions( state.range( 0 ) ) };
+  const bool move{ state.range( 1 ) != 0 };
+
+  for ( auto _ : state )
+  {
+    if ( move )
+    {
+      state.PauseTiming();
+      auto copy{ definitions };
+      state.ResumeTiming();
+      benchmark::DoNotOptimize( lb::options::Options<int>{ std::move( copy ) } );
+    }
+    else
+    {
+      benchmark::DoNotOptimize( lb::options::Options<int>{ definitions.cbegin(), definitions.cend() } );
+    }
+  }
+  state.SetItemsProcessed( state.iterations() * definitions.size() );
+}
+BENCHMARK( BM_ConstructFromDefinitions )->ArgsProduct( { { 10, 100, 1000, 10000 }, { 0, 1 } } );
+
+
+// The same options taken from a snapshot, which only has its header checked.
+void BM_LoadSnapshot( benchmark::State& state )
+{
+  const auto blob{ lb::options::writeSnapshot( lb::options::Options<int>{ makeDefinitions( state.range( 0 ) ) } ) };
+
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( lb::options::OptionsSnapshot<int>{ blob.data(), blob.size() } );
+  }
+}
+BENCHMARK( BM_LoadSnapshot )->Arg( 10 )->Arg( 100 )->Arg( 1000 )->Arg( 10000 );
+
+
+} // End of anonymous namespace
@@ -0,0 +1,175 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <lb/options/FlagTrie.h>
+#include <lb/options/PerfectHash.h>
+
+
+namespace
+{
+
+
+// Dotted flags in groups of 20 e.g. "group12.setting7".
+std::vector<std::string> makeFlags( std::size_t count )
+{
+  std::vector<std::string> flags;
+  flags.reserve( count );
+  for ( std::size_t i = 0; i < count; ++i )
+  {
+    flags.push_back( "group" + std::to_string( i / 20 ) + ".setting" + std::to_string( i % 20 ) );
+  }
+  return flags;
+}
+
+lb::options::FlagTrie makeTrie( const std::vector<std::string>& flags )
+{
+  std::vector<lb::options::FlagTrie::Entry> entries;
+  for ( std::size_t i = 0; i < flags.size(); ++i )
+  {
+    entries.push_back( { flags[i], static_cast<lb::options::FlagTrie::Index>( i ) } );
+  }
+  return lb::options::FlagTrie{ std::move( entries ) };
+}
+
+
+void BM_LongLookupHashed( benchmark::State& state )
+{
+  const auto flags{ makeFlags( state.range( 0 ) ) };
+  std::unordered_map<std::string_view, std::size_t> byLong;
+  for ( std::size_t i = 0; i < flags.size(); ++i )
+  {
+    byLong[ flags[i] ] = i;
+  }
+
+  std::size_t i{ 0 };
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( byLong.find( flags[ i ] ) );
+    i = ( i + 7919 ) % flags.size();
+  }
+}
+BENCHMARK( BM_LongLookupHashed )->RangeMultiplier( 10 )->Range( 100, 10000 );
+
+
+void BM_LongLookupTrie( benchmark::State& state )
+{
+  const auto flags{ makeFlags( state.range( 0 ) ) };
+  const auto trie{ makeTrie( flags ) };
+
+  std::size_t i{ 0 };
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( trie.find( flags[ i ] ) );
+    i = ( i + 7919 ) % flags.size();
+  }
+}
+BENCHMARK( BM_LongLookupTrie )->RangeMultiplier( 10 )->Range( 100, 10000 );
+
+
+void BM_LongLookupPerfectHash( benchmark::State& state )
+{
+  const auto flags{ makeFlags( state.range( 0 ) ) };
+  std::vector<std::uint64_t> hashes;
+  for ( const auto& flag : flags )
+  {
+    hashes.push_back( lb::options::hashString( flag ) );
+  }
+  lb::options::MinimalPerfectHash mph;
+  mph.build( hashes );
+
+  // Hash plus the compare against the stored flag, as Options does.
+  std::size_t i{ 0 };
+  for ( auto _ : state )
+  {
+    const auto found{ mph.find( lb::options::hashString( flags[ i ] ) ) };
+    benchmark::DoNotOptimize( flags[ found ] == flags[ i ] );
+    i = ( i + 7919 ) % flags.size();
+  }
+}
+BENCHMARK( BM_LongLookupPerfectHash )->RangeMultiplier( 10 )->Range( 100, 10000 );
+
+
+void BM_LongAbbreviationTrie( benchmark::State& state )
+{
+  const auto flags{ makeFlags( state.range( 0 ) ) };
+  const auto trie{ makeTrie( flags ) };
+
+  // Drop the last character of settings 10 to 19, still unambiguous.
+  std::vector<std::string> abbreviations;
+  for ( std::size_t i = 10; i < flags.size(); i += 20 )
+  {
+    abbreviations.push_back( flags[i].substr( 0, flags[i].size() - 1 ) );
+  }
+
+  std::size_t i{ 0 };
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( trie.findUnambiguous( abbreviations[ i ] ) );
+    i = ( i + 1 ) % abbreviations.size();
+  }
+}
+BENCHMARK( BM_LongAbbreviationTrie )->RangeMultiplier( 10 )->Range( 100, 10000 );
+
+
+void BM_LongPrefixTrie( benchmark::State& state )
+{
+  const auto flags{ makeFlags( state.range( 0 ) ) };
+  const auto trie{ makeTrie( flags ) };
+
+  std::size_t group{ 0 };
+  const std::size_t numGroups{ flags.size() / 20 };
+  for ( auto _ : state )
+  {
+    const std::string prefix{ "group" + std::to_string( group ) + "." };
+    std::size_t found{ 0 };
+    trie.forEachWithPrefix( prefix, [&found]( lb::options::FlagTrie::Index ) { ++found; } );
+    benchmark::DoNotOptimize( found );
+    group = ( group + 1 ) % numGroups;
+  }
+}
+BENCHMARK( BM_LongPrefixTrie )->RangeMultiplier( 10 )->Range( 100, 10000 );
+
+
+void BM_LongBuildTrie( benchmark::State& state )
+{
+  const auto flags{ makeFlags( state.range( 0 ) ) };
+
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( makeTrie( flags ) );
+  }
+}
+BENCHMARK( BM_LongBuildTrie )->RangeMultiplier( 10 )->Range( 100, 10000 );
+
+
+} // End of anonymous namespace
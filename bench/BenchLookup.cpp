@@ -0,0 +1,145 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <lb/options/EnumCount.h>
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+// An enum with an EnumCount so that it is stored densely.
+enum class DenseKey : int {};
+
+
+} // End of anonymous namespace
+
+
+template<> struct lb::options::EnumCount<DenseKey>
+  : std::integral_constant<std::size_t, 8> {};
+
+
+namespace
+{
+
+
+/* Eight long options taking a value, all but the last given on the command
+   line, the sort of thing a request handler might consult over and over.
+ */
+template< class Key >
+const lb::options::Options<Key>& getOptions()
+{
+  static const lb::options::Options<Key> options
+  {
+    { Key( 0 ), '\0', "host"    , 1, 1 },
+    { Key( 1 ), '\0', "port"    , 1, 1 },
+    { Key( 2 ), '\0', "user"    , 1, 1 },
+    { Key( 3 ), '\0', "password", 1, 1 },
+    { Key( 4 ), '\0', "database", 1, 1 },
+    { Key( 5 ), '\0', "timeout" , 1, 1 },
+    { Key( 6 ), '\0', "log-file", 1, 1 },
+    { Key( 7 ), '\0', "absent"  , 1, 1 },
+  };
+  return options;
+}
+
+template< class Key >
+lb::options::ParsedOptions<Key> parseOptions()
+{
+  const char* argv[15]
+  {
+    "exe",
+    "--host", "a-rather-long-host-name.example.com",
+    "--port", "8080",
+    "--user", "someone",
+    "--password", "a password long enough to need an allocation",
+    "--database", "production",
+    "--timeout", "30",
+    "--log-file", "/var/log/some/service/with/a/long/path.log",
+  };
+  return getOptions<Key>().parse( 15, const_cast<char**>( argv ) );
+}
+
+
+template< class Key >
+void BM_IsPresent( benchmark::State& state )
+{
+  const auto parsed{ parseOptions<Key>() };
+  int i{ 0 };
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( parsed.isPresent( Key( i ) ) );
+    i = ( i + 1 ) & 7;
+  }
+}
+BENCHMARK_TEMPLATE( BM_IsPresent, int );
+BENCHMARK_TEMPLATE( BM_IsPresent, DenseKey );
+
+
+template< class Key >
+void BM_GetLatestValue( benchmark::State& state )
+{
+  const auto parsed{ parseOptions<Key>() };
+  int i{ 0 };
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( parsed.getLatestValue( Key( i ) ) );
+    i = ( i + 1 ) & 7;
+  }
+}
+BENCHMARK_TEMPLATE( BM_GetLatestValue, int );
+BENCHMARK_TEMPLATE( BM_GetLatestValue, DenseKey );
+
+
+template< class Key >
+void BM_GetLatestValueHandle( benchmark::State& state )
+{
+  const auto parsed{ parseOptions<Key>() };
+  std::vector<lb::options::OptionHandle> handles;
+  for ( int i = 0; i < 8; ++i )
+  {
+    handles.push_back( getOptions<Key>().handle( Key( i ) ) );
+  }
+  int i{ 0 };
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( parsed.getLatestValue( handles[i] ) );
+    i = ( i + 1 ) & 7;
+  }
+}
+BENCHMARK_TEMPLATE( BM_GetLatestValueHandle, int );
+BENCHMARK_TEMPLATE( BM_GetLatestValueHandle, DenseKey );
+
+
+} // End of anonymous namespace
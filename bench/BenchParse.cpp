@@ -0,0 +1,332 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <lb/options/Bindings.h>
+#include <lb/options/Options.h>
+#include <lb/options/ParseCache.h>
+
+
+namespace
+{
+
+
+// Key ranges of the schema below.
+constexpr int NumLong{ 64 };
+constexpr int FirstLong{ 'z' + 1 };
+constexpr int List{ FirstLong + NumLong };
+constexpr int NumDefaults{ 32 };
+constexpr int FirstDefault{ List + 1 };
+
+/* Short flags a to z taking no values, long flags flag0 to flag63 taking one
+   value each, a list flag taking any number and a batch of options with three
+   default values each.
+ */
+const lb::options::Options<int>& getOptions()
+{
+  static const lb::options::Options<int> options
+  {
+#define LB_SHORT( c ) { c, c, {}, 0, 0 }
+    LB_SHORT( 'a' ), LB_SHORT( 'b' ), LB_SHORT( 'c' ), LB_SHORT( 'd' ), LB_SHORT( 'e' ), LB_SHORT( 'f' ),
+    LB_SHORT( 'g' ), LB_SHORT( 'h' ), LB_SHORT( 'i' ), LB_SHORT( 'j' ), LB_SHORT( 'k' ), LB_SHORT( 'l' ),
+    LB_SHORT( 'm' ), LB_SHORT( 'n' ), LB_SHORT( 'o' ), LB_SHORT( 'p' ), LB_SHORT( 'q' ), LB_SHORT( 'r' ),
+    LB_SHORT( 's' ), LB_SHORT( 't' ), LB_SHORT( 'u' ), LB_SHORT( 'v' ), LB_SHORT( 'w' ), LB_SHORT( 'x' ),
+    LB_SHORT( 'y' ), LB_SHORT( 'z' ),
+#undef LB_SHORT
+#define LB_LONG( n ) { FirstLong + n, '\0', "flag" #n, 1, 1 }
+    LB_LONG( 0 ),  LB_LONG( 1 ),  LB_LONG( 2 ),  LB_LONG( 3 ),  LB_LONG( 4 ),  LB_LONG( 5 ),  LB_LONG( 6 ),  LB_LONG( 7 ),
+    LB_LONG( 8 ),  LB_LONG( 9 ),  LB_LONG( 10 ), LB_LONG( 11 ), LB_LONG( 12 ), LB_LONG( 13 ), LB_LONG( 14 ), LB_LONG( 15 ),
+    LB_LONG( 16 ), LB_LONG( 17 ), LB_LONG( 18 ), LB_LONG( 19 ), LB_LONG( 20 ), LB_LONG( 21 ), LB_LONG( 22 ), LB_LONG( 23 ),
+    LB_LONG( 24 ), LB_LONG( 25 ), LB_LONG( 26 ), LB_LONG( 27 ), LB_LONG( 28 ), LB_LONG( 29 ), LB_LONG( 30 ), LB_LONG( 31 ),
+    LB_LONG( 32 ), LB_LONG( 33 ), LB_LONG( 34 ), LB_LONG( 35 ), LB_LONG( 36 ), LB_LONG( 37 ), LB_LONG( 38 ), LB_LONG( 39 ),
+    LB_LONG( 40 ), LB_LONG( 41 ), LB_LONG( 42 ), LB_LONG( 43 ), LB_LONG( 44 ), LB_LONG( 45 ), LB_LONG( 46 ), LB_LONG( 47 ),
+    LB_LONG( 48 ), LB_LONG( 49 ), LB_LONG( 50 ), LB_LONG( 51 ), LB_LONG( 52 ), LB_LONG( 53 ), LB_LONG( 54 ), LB_LONG( 55 ),
+    LB_LONG( 56 ), LB_LONG( 57 ), LB_LONG( 58 ), LB_LONG( 59 ), LB_LONG( 60 ), LB_LONG( 61 ), LB_LONG( 62 ), LB_LONG( 63 ),
+#undef LB_LONG
+    { List, '\0', "list", -1, -1 },
+#define LB_DEFAULT( n ) { FirstDefault + n, '\0', "default" #n, 0, 3, {}, { "default value one", "default value two", "default value three" } }
+    LB_DEFAULT( 0 ),  LB_DEFAULT( 1 ),  LB_DEFAULT( 2 ),  LB_DEFAULT( 3 ),  LB_DEFAULT( 4 ),  LB_DEFAULT( 5 ),  LB_DEFAULT( 6 ),  LB_DEFAULT( 7 ),
+    LB_DEFAULT( 8 ),  LB_DEFAULT( 9 ),  LB_DEFAULT( 10 ), LB_DEFAULT( 11 ), LB_DEFAULT( 12 ), LB_DEFAULT( 13 ), LB_DEFAULT( 14 ), LB_DEFAULT( 15 ),
+    LB_DEFAULT( 16 ), LB_DEFAULT( 17 ), LB_DEFAULT( 18 ), LB_DEFAULT( 19 ), LB_DEFAULT( 20 ), LB_DEFAULT( 21 ), LB_DEFAULT( 22 ), LB_DEFAULT( 23 ),
+    LB_DEFAULT( 24 ), LB_DEFAULT( 25 ), LB_DEFAULT( 26 ), LB_DEFAULT( 27 ), LB_DEFAULT( 28 ), LB_DEFAULT( 29 ), LB_DEFAULT( 30 ), LB_DEFAULT( 31 ),
+#undef LB_DEFAULT
+  };
+  return options;
+}
+
+
+// Holds the strings of an argv so that it can be handed to parse.
+struct Argv
+{
+  explicit Argv( std::vector<std::string> a )
+    : args{ std::move( a ) }
+  {
+    args.insert( args.begin(), "exe" );
+    for ( auto& arg : args )
+    {
+      pointers.push_back( arg.data() );
+    }
+  }
+
+  int argc() const { return static_cast<int>( pointers.size() ); }
+  char** argv() { return pointers.data(); }
+
+  std::vector<std::string> args;
+  std::vector<char*> pointers;
+};
+
+
+Argv makeClusteredShorts( std::size_t argc )
+{
+  std::vector<std::string> args;
+  for ( std::size_t i = 0; i < argc; ++i )
+  {
+    args.push_back( "-abcdefgh" );
+  }
+  return Argv{ std::move( args ) };
+}
+
+Argv makeLongFlags( std::size_t argc )
+{
+  std::vector<std::string> args;
+  for ( std::size_t i = 0; i + 1 < argc; i += 2 )
+  {
+    args.push_back( "--flag" + std::to_string( ( i / 2 ) % NumLong ) );
+    args.push_back( "a value of moderate length " + std::to_string( i ) );
+  }
+  return Argv{ std::move( args ) };
+}
+
+Argv makeTrailing( std::size_t argc )
+{
+  std::vector<std::string> args{ "-v" };
+  for ( std::size_t i = 1; i < argc; ++i )
+  {
+    args.push_back( "/some/path/to/a/file" + std::to_string( i ) + ".txt" );
+  }
+  return Argv{ std::move( args ) };
+}
+
+Argv makeList( std::size_t argc )
+{
+  std::vector<std::string> args{ "--list" };
+  for ( std::size_t i = 1; i < argc; ++i )
+  {
+    args.push_back( "item" + std::to_string( i ) );
+  }
+  return Argv{ std::move( args ) };
+}
+
+// Everything defaulted bar the one flag given.
+Argv makeDefaults( std::size_t )
+{
+  return Argv{ { "--default0", "given" } };
+}
+
+
+// Counts the events of an event parse.
+struct CountingHandler
+{
+  void onOption( int, std::string_view, std::size_t ) { ++count; }
+  void onValue( int, std::string_view ) { ++count; }
+  void onTrailing( std::string_view ) { ++count; }
+  void onDefault( int, const std::vector<std::string>& ) { ++count; }
+
+  std::size_t count{ 0 };
+};
+
+
+/* The second argument picks how the result is produced: 0 a new ParsedOptions
+   from parse, 1 a ParsedOptionsView, 2 parseInto one ParsedOptions and 3 only
+   events for a handler.
+ */
+template< Argv (*Make)( std::size_t ) >
+void BM_Parse( benchmark::State& state )
+{
+  const auto& options{ getOptions() };
+  Argv args{ Make( state.range( 0 ) ) };
+
+  switch ( state.range( 1 ) )
+  {
+  case 0:
+    for ( auto _ : state )
+    {
+      benchmark::DoNotOptimize( options.parse( args.argc(), args.argv() ) );
+    }
+    break;
+  case 1:
+    for ( auto _ : state )
+    {
+      benchmark::DoNotOptimize( options.parseView( args.argc(), args.argv() ) );
+    }
+    break;
+  case 2:
+    {
+      lb::options::ParsedOptions<int> parsed;
+      for ( auto _ : state )
+      {
+        options.parseInto( parsed, args.argc(), args.argv() );
+        benchmark::DoNotOptimize( parsed );
+      }
+    }
+    break;
+  default:
+    for ( auto _ : state )
+    {
+      CountingHandler handler;
+      options.parse( args.argc(), args.argv(), handler );
+      benchmark::DoNotOptimize( handler.count );
+    }
+    break;
+  }
+  state.SetItemsProcessed( state.iterations() * args.argc() );
+}
+
+const std::vector<std::int64_t> argcs{ 8, 64, 512, 4096 };
+const std::vector<std::int64_t> modes{ 0, 1, 2, 3 };
+
+BENCHMARK_TEMPLATE( BM_Parse, makeClusteredShorts )->ArgsProduct( { argcs, modes } );
+BENCHMARK_TEMPLATE( BM_Parse, makeLongFlags )->ArgsProduct( { argcs, modes } );
+BENCHMARK_TEMPLATE( BM_Parse, makeTrailing )->ArgsProduct( { { 64, 4096, 65536 }, modes } );
+BENCHMARK_TEMPLATE( BM_Parse, makeList )->ArgsProduct( { { 64, 4096, 65536 }, modes } );
+BENCHMARK_TEMPLATE( BM_Parse, makeDefaults )->ArgsProduct( { { 3 }, modes } );
+
+
+/* Reading all 64 long flags into strings, the argument picking how: 0 by
+   parseInto then getLatestValue for each and 1 through Bindings.
+ */
+void BM_Bind( benchmark::State& state )
+{
+  const auto& options{ getOptions() };
+  Argv args{ makeLongFlags( 2 * NumLong ) };
+
+  std::vector<std::string> values( NumLong );
+  lb::options::Bindings<int> bindings;
+  for ( int i = 0; i < NumLong; ++i )
+  {
+    bindings.bind( FirstLong + i, values[i] );
+  }
+
+  lb::options::ParsedOptions<int> parsed;
+  for ( auto _ : state )
+  {
+    if ( state.range( 0 ) == 0 )
+    {
+      options.parseInto( parsed, args.argc(), args.argv() );
+      for ( int i = 0; i < NumLong; ++i )
+      {
+        values[i] = parsed.getLatestValue( FirstLong + i );
+      }
+    }
+    else
+    {
+      options.parse( args.argc(), args.argv(), bindings );
+    }
+    benchmark::DoNotOptimize( values.data() );
+  }
+}
+
+BENCHMARK( BM_Bind )->Arg( 0 )->Arg( 1 );
+
+
+/* Rejecting a line whose last flag is unknown, the argument picking the path:
+   0 parse throwing and catching and 1 tryParseInto on one ParsedOptions.
+ */
+void BM_Reject( benchmark::State& state )
+{
+  const auto& options{ getOptions() };
+  Argv args{ makeLongFlags( 8 ) };
+  args.args.back() = "--no-such-flag";
+  args.pointers.back() = args.args.back().data();
+
+  lb::options::ParsedOptions<int> parsed;
+  for ( auto _ : state )
+  {
+    if ( state.range( 0 ) == 0 )
+    {
+      try
+      {
+        benchmark::DoNotOptimize( options.parse( args.argc(), args.argv() ) );
+      }
+      catch ( const std::runtime_error& e )
+      {
+        benchmark::DoNotOptimize( e.what() );
+      }
+    }
+    else
+    {
+      benchmark::DoNotOptimize( options.tryParseInto( parsed, args.argc(), args.argv() ) );
+    }
+  }
+}
+
+BENCHMARK( BM_Reject )->Arg( 0 )->Arg( 1 );
+
+
+/* Long flags through a ParseCache, the second argument picking the stream:
+   0 the same line over and over, 1 two lines alternating that differ only in
+   the last value and 2 that same pair with parseInto for comparison.
+ */
+void BM_ParseCache( benchmark::State& state )
+{
+  const auto& options{ getOptions() };
+  Argv first{ makeLongFlags( state.range( 0 ) ) };
+  Argv second{ makeLongFlags( state.range( 0 ) ) };
+  second.args.back() = "a different value";
+  second.pointers.back() = second.args.back().data();
+  Argv* const lines[2]{ &first, state.range( 1 ) == 0 ? &first : &second };
+
+  lb::options::ParseCache<int> cache{ options };
+  lb::options::ParsedOptions<int> parsed;
+  std::size_t i{ 0 };
+  for ( auto _ : state )
+  {
+    Argv& args{ *lines[ i++ % 2 ] };
+    if ( state.range( 1 ) == 2 )
+    {
+      options.parseInto( parsed, args.argc(), args.argv() );
+      benchmark::DoNotOptimize( parsed );
+    }
+    else
+    {
+      benchmark::DoNotOptimize( cache.parse( args.argc(), args.argv() ) );
+    }
+  }
+  state.SetItemsProcessed( state.iterations() * first.argc() );
+}
+
+BENCHMARK( BM_ParseCache )->ArgsProduct( { { 8, 64, 512 }, { 0, 1, 2 } } );
+
+
+} // End of anonymous namespace
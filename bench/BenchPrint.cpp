@@ -0,0 +1,150 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+#include <lb/options/OptionDefinition.h>
+#include <lb/options/Options.h>
+#include <lb/options/print.h>
+#include <lb/options/Usage.h>
+
+
+namespace
+{
+
+
+// Words of varying length with the odd paragraph break.
+std::string makeText( std::size_t length )
+{
+  static const char* const words[]{ "option", "a", "description", "of", "the", "command", "line", "parser", "is" };
+  std::string text;
+  for ( std::size_t i = 0; text.size() < length; ++i )
+  {
+    text += words[ i % 9 ];
+    text += ( i % 97 == 96 ) ? '\n' : ' ';
+  }
+  text.resize( length );
+  return text;
+}
+
+
+void BM_Split( benchmark::State& state )
+{
+  const std::string text{ makeText( state.range( 0 ) ) };
+  const std::string indent( 8, ' ' );
+  std::ostringstream oss;
+
+  for ( auto _ : state )
+  {
+    oss.str( {} );
+    lb::options::split( oss, text, indent, false, 64 );
+    benchmark::DoNotOptimize( oss );
+  }
+  state.SetBytesProcessed( state.iterations() * text.size() );
+}
+BENCHMARK( BM_Split )->RangeMultiplier( 8 )->Range( 64, 32768 );
+
+
+void BM_AppendWrapped( benchmark::State& state )
+{
+  const std::string text{ makeText( state.range( 0 ) ) };
+  const std::string indent( 8, ' ' );
+  std::string out;
+
+  for ( auto _ : state )
+  {
+    out.clear();
+    lb::options::appendWrapped( out, text, indent, false, 64 );
+    benchmark::DoNotOptimize( out );
+  }
+  state.SetBytesProcessed( state.iterations() * text.size() );
+}
+BENCHMARK( BM_AppendWrapped )->RangeMultiplier( 8 )->Range( 64, 32768 );
+
+
+void BM_Print( benchmark::State& state )
+{
+  lb::options::OptionDefinition option{ 'o', "a-fairly-long-option-name", 0, 9, makeText( state.range( 0 ) ) };
+  for ( int i = 0; i < 9; ++i )
+  {
+    option.defaultValues.push_back( "default-" + std::to_string( i ) );
+  }
+  std::ostringstream oss;
+
+  for ( auto _ : state )
+  {
+    oss.str( {} );
+    lb::options::print( oss, option, 4 );
+    benchmark::DoNotOptimize( oss );
+  }
+  state.SetBytesProcessed( state.iterations() * option.description.size() );
+}
+BENCHMARK( BM_Print )->RangeMultiplier( 8 )->Range( 64, 32768 );
+
+
+/* The whole usage of 2k options with descriptions and defaults, the argument
+   picking how: 0 print for each option, 1 printUsage and 2 a UsageCache.
+ */
+void BM_PrintUsage( benchmark::State& state )
+{
+  std::vector<lb::options::KeyedOptionDefinition<int>> definitions;
+  for ( int i = 0; i < 2000; ++i )
+  {
+    definitions.push_back( { i, '\0', "option-" + std::to_string( i ), 0, 2, makeText( 200 ), { "default-1", "default-2" } } );
+  }
+  const lb::options::Options<int> options{ std::move( definitions ) };
+  lb::options::UsageCache<int> cache{ options };
+  std::ostringstream oss;
+
+  for ( auto _ : state )
+  {
+    oss.str( {} );
+    switch ( state.range( 0 ) )
+    {
+    case 0:
+      for ( std::size_t slot = 0; slot < options.size(); ++slot )
+      {
+        lb::options::print( oss, options.definitionAt( slot ).option, 4 );
+      }
+      break;
+    case 1:
+      lb::options::printUsage( oss, options, 72 );
+      break;
+    default:
+      cache.print( oss, 72 );
+      break;
+    }
+    benchmark::DoNotOptimize( oss );
+  }
+}
+BENCHMARK( BM_PrintUsage )->Arg( 0 )->Arg( 1 )->Arg( 2 );
+
+
+} // End of anonymous namespace
@@ -0,0 +1,117 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+// Every lower case letter is a short flag taking no values.
+const lb::options::Options<char> shortOptions
+{
+  { 'a', 'a' }, { 'b', 'b' }, { 'c', 'c' }, { 'd', 'd' }, { 'e', 'e' }, { 'f', 'f' },
+  { 'g', 'g' }, { 'h', 'h' }, { 'i', 'i' }, { 'j', 'j' }, { 'k', 'k' }, { 'l', 'l' },
+  { 'm', 'm' }, { 'n', 'n' }, { 'o', 'o' }, { 'p', 'p' }, { 'q', 'q' }, { 'r', 'r' },
+  { 's', 's' }, { 't', 't' }, { 'u', 'u' }, { 'v', 'v' }, { 'w', 'w' }, { 'x', 'x' },
+  { 'y', 'y' }, { 'z', 'z' },
+};
+
+std::string makeCluster( std::size_t length )
+{
+  std::string cluster{ "-" };
+  for ( std::size_t i = 0; i < length; ++i )
+  {
+    cluster += static_cast<char>( 'a' + ( i * 7 ) % 26 );
+  }
+  return cluster;
+}
+
+
+// The lookup Options used to do for each character of a cluster.
+void BM_ShortLookupHashed( benchmark::State& state )
+{
+  std::unordered_map< char, const lb::options::KeyedOptionDefinition<char>* > byShort;
+  for ( char c = 'a'; c <= 'z'; ++c )
+  {
+    byShort[c] = shortOptions.findShort( c );
+  }
+  const std::string cluster{ makeCluster( state.range( 0 ) ) };
+
+  for ( auto _ : state )
+  {
+    for ( std::string::size_type j = 1; j < cluster.size(); ++j )
+    {
+      benchmark::DoNotOptimize( byShort.find( cluster[j] )->second );
+    }
+  }
+  state.SetItemsProcessed( state.iterations() * ( cluster.size() - 1 ) );
+}
+BENCHMARK( BM_ShortLookupHashed )->RangeMultiplier( 8 )->Range( 8, 4096 );
+
+
+// The lookup Options does now.
+void BM_ShortLookupTable( benchmark::State& state )
+{
+  const std::string cluster{ makeCluster( state.range( 0 ) ) };
+
+  for ( auto _ : state )
+  {
+    for ( std::string::size_type j = 1; j < cluster.size(); ++j )
+    {
+      benchmark::DoNotOptimize( shortOptions.findShort( cluster[j] ) );
+    }
+  }
+  state.SetItemsProcessed( state.iterations() * ( cluster.size() - 1 ) );
+}
+BENCHMARK( BM_ShortLookupTable )->RangeMultiplier( 8 )->Range( 8, 4096 );
+
+
+// A whole parse of a single long cluster.
+void BM_ParseShortCluster( benchmark::State& state )
+{
+  std::string cluster{ makeCluster( state.range( 0 ) ) };
+  char exe[]{ "exe" };
+  char* argv[2]{ exe, cluster.data() };
+
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( shortOptions.parseView( 2, argv ) );
+  }
+  state.SetItemsProcessed( state.iterations() * ( cluster.size() - 1 ) );
+}
+BENCHMARK( BM_ParseShortCluster )->RangeMultiplier( 8 )->Range( 8, 4096 );
+
+
+} // End of anonymous namespace
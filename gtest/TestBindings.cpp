@@ -0,0 +1,146 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <lb/options/Bindings.h>
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class BindingsEnum
+{
+  eVerbose,
+  eThreads,
+  eName,
+  eRatios,
+  eLevel,
+  eTags,
+  eUnbound,
+};
+
+
+const lb::options::Options<BindingsEnum>& getOptions()
+{
+  static const lb::options::Options<BindingsEnum> options
+  {
+    { BindingsEnum::eVerbose, 'v' , "verbose", 0,  0, "Say more." },
+    { BindingsEnum::eThreads, 't' , "threads", 1,  1, "How many threads.", { "4" } },
+    { BindingsEnum::eName   , 'n' , "name"   , 1,  1, "A name." },
+    { BindingsEnum::eRatios , '\0', "ratios" , 1, -1, "Some ratios." },
+    { BindingsEnum::eLevel  , '\0', "level"  , 1,  1, "A level." },
+    { BindingsEnum::eTags   , '\0', "tags"   , 0, -1, "Some tags.", { "a", "b" } },
+    { BindingsEnum::eUnbound, 'u' , {}       , 1,  1, "Not bound." },
+  };
+  return options;
+}
+
+
+void testBindings()
+{
+  bool verbose{ false };
+  int threads{ 0 };
+  std::string name{ "unchanged" };
+  std::vector<double> ratios;
+  std::vector<std::string> tags;
+  std::vector<std::string> levels;
+  std::vector<std::string> trailing;
+
+  lb::options::Bindings<BindingsEnum> bindings;
+  bindings.bind( BindingsEnum::eVerbose, verbose )
+          .bind( BindingsEnum::eThreads, threads )
+          .bind( BindingsEnum::eName, name )
+          .bind( BindingsEnum::eRatios, ratios )
+          .bind( BindingsEnum::eTags, tags )
+          .bind( BindingsEnum::eLevel, [&levels]( std::string_view value ) { levels.emplace_back( value ); } )
+          .bindTrailing( trailing );
+
+  const char* argv[12]{ { "exe" }, { "-v" }, { "--ratios" }, { "0.5" }, { "2" }, { "-u" }, { "x" }
+                      , { "--ratios" }, { "1e3" }, { "--level" }, { "debug" }, { "t" } };
+  getOptions().parse( 12, const_cast<char**>( argv ), bindings );
+
+  EXPECT_TRUE( verbose );
+  EXPECT_EQ( threads, 4 );          // From its default
+  EXPECT_EQ( name, "unchanged" );   // Left out without a default
+  EXPECT_EQ( ratios, ( std::vector<double>{ 0.5, 2, 1000 } ) );
+  EXPECT_EQ( tags, ( std::vector<std::string>{ "a", "b" } ) );
+  EXPECT_EQ( levels, std::vector<std::string>{ "debug" } );
+  EXPECT_EQ( trailing, std::vector<std::string>{ "t" } );
+
+  // The last value wins.
+  const char* again[5]{ { "exe" }, { "-t" }, { "8" }, { "--threads" }, { "16" } };
+  getOptions().parse( 5, const_cast<char**>( again ), bindings );
+  EXPECT_EQ( threads, 16 );
+
+  // Rebinding replaces.
+  int otherThreads{ 0 };
+  bindings.bind( BindingsEnum::eThreads, otherThreads );
+  getOptions().parse( 5, const_cast<char**>( again ), bindings );
+  EXPECT_EQ( otherThreads, 16 );
+}
+
+
+void testBindingsInvalid()
+{
+  int threads{ 0 };
+  lb::options::Bindings<BindingsEnum> bindings;
+  bindings.bind( BindingsEnum::eThreads, threads );
+
+  const char* argv[3]{ { "exe" }, { "--threads" }, { "4x" } };
+  try
+  {
+    getOptions().parse( 3, const_cast<char**>( argv ), bindings );
+    ADD_FAILURE() << "No exception";
+  }
+  catch ( const std::runtime_error& e )
+  {
+    EXPECT_STREQ( e.what(), "Invalid value 4x for option threads" );
+  }
+
+  EXPECT_EQ( lb::options::convertValue<bool>( "true", {} ), true );
+  EXPECT_EQ( lb::options::convertValue<bool>( "0", {} ), false );
+  EXPECT_THROW( lb::options::convertValue<bool>( "yes", {} ), std::runtime_error );
+  EXPECT_THROW( lb::options::convertValue<unsigned>( "-1", {} ), std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, Bindings)
+{
+  testBindings();
+  testBindingsInvalid();
+}
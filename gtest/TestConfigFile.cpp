@@ -0,0 +1,175 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class ConfigEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+  eLongC,
+  eSectioned,
+};
+
+
+// A config file that deletes itself.
+struct TemporaryFile
+{
+  explicit TemporaryFile( const std::string& contents )
+  {
+    char name[]{ "/tmp/lbOptionsConfigXXXXXX" };
+    const int fd{ ::mkstemp( name ) };
+    ::close( fd );
+    path = name;
+    std::ofstream{ path } << contents;
+  }
+  ~TemporaryFile() { std::remove( path.c_str() ); }
+
+  std::string path;
+};
+
+
+const lb::options::Options<ConfigEnum>& getOptions()
+{
+  static const lb::options::Options<ConfigEnum> options
+  {
+    { ConfigEnum::eShortA   , 'a' , {}              , 0,  0, "A flag." },
+    { ConfigEnum::eShortB   , 'b' , "bees"          , 1, -1, "An option that requires at least one argument." },
+    { ConfigEnum::eLongA    , '\0', "long-option-a" , 1,  1, "A long option with a default.", { "default-a" } },
+    { ConfigEnum::eLongB    , '\0', "long-option-b" , 1,  1, "A long option that requires a single argument." },
+    { ConfigEnum::eLongC    , '\0', "long-option-c" , 0,  0, "A long flag." },
+    { ConfigEnum::eSectioned, '\0', "server.port"   , 1,  1, "An option set within a section." },
+  };
+  return options;
+}
+
+
+void testConfigFile()
+{
+  const TemporaryFile file{ "# A comment\n"
+                            "; Another comment\n"
+                            "\n"
+                            "  long-option-a = from-file  \n"
+                            "long-option-b=file-b\n"
+                            "bees = 'one value' two\n"
+                            "bees = three\n"
+                            "long-option-c\n"
+                            "[ server ]\n"
+                            "port = 8080\r\n" };
+
+  const char* argv[4]{ { "exe" }, { "--long-option-b" }, { "from-argv" }, { "-a" } };
+  const auto parsed{ getOptions().parse( 4, const_cast<char**>( argv ), file.path ) };
+  EXPECT_TRUE( parsed.isPresent( ConfigEnum::eShortA ) );
+  EXPECT_EQ( parsed.getLatestValue( ConfigEnum::eLongA ), "from-file" ); // Over the default
+  EXPECT_EQ( parsed.optionsByKey.at( ConfigEnum::eLongB ).occurrences.size(), 1 ); // Argv only
+  EXPECT_EQ( parsed.getLatestValue( ConfigEnum::eLongB ), "from-argv" );
+  const auto& bees{ parsed.optionsByKey.at( ConfigEnum::eShortB ).occurrences };
+  ASSERT_EQ( bees.size(), 2 );
+  EXPECT_EQ( bees[0].values, ( std::vector<std::string>{ "one value", "two" } ) );
+  EXPECT_EQ( bees[1].values, std::vector<std::string>{ "three" } );
+  EXPECT_TRUE( parsed.isPresent( ConfigEnum::eLongC ) );
+  EXPECT_EQ( parsed.getLatestValue( ConfigEnum::eSectioned ), "8080" );
+
+  // Only the argv options have positions.
+  EXPECT_EQ( parsed.optionsByArgvPosition.size(), 2 );
+
+  // A view keeps the file mapped.
+  lb::options::ParsedOptionsView<ConfigEnum> view;
+  getOptions().parseInto( view, 4, const_cast<char**>( argv ), file.path );
+  EXPECT_EQ( view.getLatestValue( ConfigEnum::eSectioned ), "8080" );
+  EXPECT_EQ( view.mappedFiles.size(), 1 );
+
+  // Without a file the defaults still apply.
+  const auto empty{ TemporaryFile{ "" } };
+  const auto defaulted{ getOptions().parse( 1, const_cast<char**>( argv ), empty.path ) };
+  EXPECT_EQ( defaulted.getLatestValue( ConfigEnum::eLongA ), "default-a" );
+}
+
+
+void testConfigFileErrors()
+{
+  const char* argv[1]{ { "exe" } };
+  const auto parse = [ &argv ]( const std::string& contents )
+  {
+    const TemporaryFile file{ contents };
+    getOptions().parse( 1, const_cast<char**>( argv ), file.path );
+  };
+
+  EXPECT_NO_THROW( parse( "long-option-b = b\n" ) );
+  EXPECT_THROW( parse( "no-such-option = b\n" ), std::runtime_error );
+  EXPECT_THROW( parse( "port = 8080\n" ), std::runtime_error ); // Outside its section
+  EXPECT_THROW( parse( "long-option-b\n" ), std::runtime_error );
+  EXPECT_THROW( parse( "long-option-b = b c\n" ), std::runtime_error );
+  EXPECT_THROW( parse( "long-option-c = true\n" ), std::runtime_error );
+  EXPECT_THROW( parse( "[section\n" ), std::runtime_error );
+  EXPECT_THROW( parse( "= value\n" ), std::runtime_error );
+  EXPECT_THROW( parse( "long-option-b = 'open\n" ), std::runtime_error );
+  EXPECT_THROW( getOptions().parse( 1, const_cast<char**>( argv ), "/no/such/file" ), std::runtime_error );
+
+  // The message says where.
+  try
+  {
+    parse( "# Fine\nlong-option-b = b\nno-such-option\n" );
+    FAIL();
+  }
+  catch ( const std::runtime_error& e )
+  {
+    EXPECT_NE( std::string{ e.what() }.find( ":3: Unknown option no-such-option" ), std::string::npos ) << e.what();
+  }
+
+  // A view that fails part way still holds the mapping its values point into.
+  const TemporaryFile file{ "long-option-b = b\nno-such-option\n" };
+  lb::options::ParsedOptionsView<ConfigEnum> view;
+  EXPECT_THROW( getOptions().parseInto( view, 1, const_cast<char**>( argv ), file.path ), std::runtime_error );
+  EXPECT_EQ( view.mappedFiles.size(), 1 );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ConfigFile)
+{
+  testConfigFile();
+  testConfigFileErrors();
+}
@@ -0,0 +1,180 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <lb/options/ConstexprOptions.h>
+
+
+namespace
+{
+
+
+enum class ConstexprEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+  eBoth,
+  eMissing,
+};
+
+using Definition = lb::options::ConstexprKeyedOptionDefinition<ConstexprEnum>;
+
+constexpr auto options{ lb::options::makeConstexprOptions<ConstexprEnum>( {
+  { ConstexprEnum::eShortA, { 'a' , {}             , 0, 0, "A short option that requires no arguments." } },
+  { ConstexprEnum::eShortB, { 'b' , {}             , 1, 1, "A short option that requires a single argument." } },
+  { ConstexprEnum::eLongA , { '\0', "long-option-a", 0, 0, "A long option that requires no arguments." } },
+  { ConstexprEnum::eLongB , { '\0', "long-option-b", 1, 3, "A long option that requires one to three arguments." } },
+  { ConstexprEnum::eBoth  , { 'c' , "long-option-c", 0, 1, "A short/long option that takes an optional argument." } },
+} ) };
+
+// All lookups can be checked at compile time.
+static_assert( options.size() == 5 );
+static_assert( options.findShort( 'a' )->key == ConstexprEnum::eShortA );
+static_assert( options.findShort( 'c' )->key == ConstexprEnum::eBoth );
+static_assert( options.findShort( 'z' ) == nullptr );
+static_assert( options.findShort( '\0' ) == nullptr );
+static_assert( options.findLong( "long-option-a" )->key == ConstexprEnum::eLongA );
+static_assert( options.findLong( "long-option-b" )->key == ConstexprEnum::eLongB );
+static_assert( options.findLong( "long-option-c" )->key == ConstexprEnum::eBoth );
+static_assert( options.findLong( "long-option-d" ) == nullptr );
+static_assert( options.findLong( "" ) == nullptr );
+static_assert( options.getDefinition( ConstexprEnum::eLongB ).maxNumValues == 3 );
+
+
+void testConstexprLookups()
+{
+  // Plenty of long flags to exercise the perfect hash properly.
+  constexpr auto manyOptions{ lb::options::makeConstexprOptions<int>( {
+    {  0, { '\0', "alpha"   } }, {  1, { '\0', "bravo"    } }, {  2, { '\0', "charlie" } },
+    {  3, { '\0', "delta"   } }, {  4, { '\0', "echo"     } }, {  5, { '\0', "foxtrot" } },
+    {  6, { '\0', "golf"    } }, {  7, { '\0', "hotel"    } }, {  8, { '\0', "india"   } },
+    {  9, { '\0', "juliett" } }, { 10, { '\0', "kilo"     } }, { 11, { '\0', "lima"    } },
+    { 12, { '\0', "mike"    } }, { 13, { '\0', "november" } }, { 14, { '\0', "oscar"   } },
+    { 15, { '\0', "papa"    } }, { 16, { '\0', "quebec"   } }, { 17, { '\0', "romeo"   } },
+    { 18, { '\0', "sierra"  } }, { 19, { '\0', "tango"    } }, { 20, { '\0', "uniform" } },
+    { 21, { '\0', "victor"  } }, { 22, { '\0', "whiskey"  } }, { 23, { '\0', "xray"    } },
+    { 24, { '\0', "yankee"  } }, { 25, { '\0', "zulu"     } }, { 26, { 'q' , {}        } },
+  } ) };
+
+  for ( int i = 0; i < 26; ++i )
+  {
+    const auto& definition{ manyOptions.getDefinition( i ) };
+    const auto* found{ manyOptions.findLong( definition.l ) };
+    ASSERT_NE( found, nullptr ) << definition.l;
+    EXPECT_EQ( found->key, i );
+  }
+  EXPECT_EQ( manyOptions.findLong( "alph" ), nullptr );
+  EXPECT_EQ( manyOptions.findLong( "zulu!" ), nullptr );
+  EXPECT_EQ( manyOptions.findShort( 'q' )->key, 26 );
+}
+
+void testConstexprParse()
+{
+  const char* argv[10]
+  {
+    { "exe" },
+    { "-ab" }, { "bbb" },
+    { "--long-option-b" }, { "x" }, { "y" },
+    { "-c" },
+    { "--long-option-a" },
+    { "--long-option-c" }, { "ccc" },
+  };
+
+  lb::options::ParsedOptions<ConstexprEnum> parsed;
+  ASSERT_NO_THROW( parsed = options.parse( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ) );
+  EXPECT_EQ( parsed.executable, argv[0] );
+  EXPECT_TRUE( parsed.isPresent( ConstexprEnum::eShortA ) );
+  EXPECT_EQ( parsed.getLatestValue( ConstexprEnum::eShortB ), "bbb" );
+  ASSERT_TRUE( parsed.isPresent( ConstexprEnum::eLongB ) );
+  EXPECT_EQ( parsed.optionsByKey[ ConstexprEnum::eLongB ].occurrences.front().values.size(), 2 );
+  EXPECT_TRUE( parsed.isPresent( ConstexprEnum::eLongA ) );
+  ASSERT_TRUE( parsed.isPresent( ConstexprEnum::eBoth ) );
+  EXPECT_EQ( parsed.optionsByKey[ ConstexprEnum::eBoth ].occurrences.size(), 2 );
+  EXPECT_EQ( parsed.getLatestValue( ConstexprEnum::eBoth ), "ccc" );
+  EXPECT_FALSE( parsed.isPresent( ConstexprEnum::eMissing ) );
+  EXPECT_EQ( parsed.optionsByArgvPosition.size(), 6 );
+
+  const auto view{ options.parseView( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ) };
+  EXPECT_EQ( view.getLatestValue( ConstexprEnum::eShortB ).data(), argv[2] );
+
+  const char* unknownArgv[2]{ { "exe" }, { "--long-option-d" } };
+  EXPECT_THROW( options.parse( 2, const_cast<char**>( unknownArgv ) ), std::runtime_error );
+
+  const char* tooFewArgv[3]{ { "exe" }, { "--long-option-b" }, { "-a" } };
+  EXPECT_THROW( options.parse( 3, const_cast<char**>( tooFewArgv ) ), std::runtime_error );
+}
+
+void testConstexprMisconfigured()
+{
+  // Built at run time the same checks throw rather than fail to compile.
+  const Definition duplicateShort[2]
+  {
+    { ConstexprEnum::eShortA, { 'a', {} } },
+    { ConstexprEnum::eShortB, { 'a', {} } },
+  };
+  EXPECT_THROW( lb::options::makeConstexprOptions( duplicateShort ), std::runtime_error );
+
+  const Definition duplicateLong[2]
+  {
+    { ConstexprEnum::eLongA, { '\0', "aaa" } },
+    { ConstexprEnum::eLongB, { '\0', "aaa" } },
+  };
+  EXPECT_THROW( lb::options::makeConstexprOptions( duplicateLong ), std::runtime_error );
+
+  const Definition duplicateKey[2]
+  {
+    { ConstexprEnum::eLongA, { 'a', {} } },
+    { ConstexprEnum::eLongA, { 'b', {} } },
+  };
+  EXPECT_THROW( lb::options::makeConstexprOptions( duplicateKey ), std::runtime_error );
+
+  const Definition noFlags[1]
+  {
+    { ConstexprEnum::eLongA, { '\0', {} } },
+  };
+  EXPECT_THROW( lb::options::makeConstexprOptions( noFlags ), std::runtime_error );
+
+  const Definition minAboveMax[1]
+  {
+    { ConstexprEnum::eLongA, { 'a', {}, 3, 2 } },
+  };
+  EXPECT_THROW( lb::options::makeConstexprOptions( minAboveMax ), std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ConstexprOptions)
+{
+  testConstexprLookups();
+  testConstexprParse();
+  testConstexprMisconfigured();
+}
@@ -0,0 +1,166 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include <lb/options/EnumCount.h>
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class DenseEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+  eUnused,
+  eOutOfRange,
+};
+
+
+} // End of anonymous namespace
+
+
+template<> struct lb::options::EnumCount<DenseEnum>
+  : std::integral_constant<std::size_t, 5> {};
+
+
+namespace
+{
+
+
+using DenseParsedOptions = lb::options::ParsedOptions<DenseEnum>;
+
+static_assert( std::is_same_v< DenseParsedOptions::OptionsByKey
+                             , lb::options::DenseMap< DenseEnum
+                                                    , DenseParsedOptions::Option
+                                                    , DenseParsedOptions::OptionsByKeyAllocator > > );
+
+static_assert( std::is_nothrow_move_constructible_v<DenseParsedOptions::OptionsByKey> );
+static_assert( std::is_nothrow_move_constructible_v<DenseParsedOptions> );
+
+
+const lb::options::Options<DenseEnum>& getOptions()
+{
+  static const lb::options::Options<DenseEnum> options
+  {
+    { DenseEnum::eShortA, 'a' , {}             , 0, 0, "A short option that requires no arguments." },
+    { DenseEnum::eShortB, 'b' , {}             , 1, 3, "A short option that requires one to three arguments." },
+    { DenseEnum::eLongA , '\0', "long-option-a", 1, 1, "A long option with a default.", { "default-a" } },
+    { DenseEnum::eLongB , '\0', "long-option-b", 1, 1, "A long option that requires a single argument." },
+  };
+  return options;
+}
+
+
+void testDenseParse()
+{
+  const auto& options{ getOptions() };
+  EXPECT_EQ( options.getDefinition( DenseEnum::eLongB ).l, "long-option-b" );
+  EXPECT_THROW( options.getDefinition( DenseEnum::eUnused ), std::runtime_error );
+
+  const char* argv[7]{ { "exe" }, { "-b" }, { "b1" }, { "--long-option-b" }, { "lb" }, { "-b" }, { "b2" } };
+  auto parsed{ options.parse( 7, const_cast<char**>( argv ) ) };
+
+  EXPECT_FALSE( parsed.isPresent( DenseEnum::eShortA ) );
+  EXPECT_TRUE( parsed.isPresent( DenseEnum::eShortB ) );
+  EXPECT_FALSE( parsed.isPresent( DenseEnum::eUnused ) );
+  EXPECT_FALSE( parsed.isPresent( DenseEnum::eOutOfRange ) );
+  EXPECT_EQ( parsed.getLatestValue( DenseEnum::eShortB ), "b2" );
+  EXPECT_EQ( parsed.getLatestValue( DenseEnum::eLongA ), "default-a" );
+  EXPECT_EQ( parsed.getLatestValue( DenseEnum::eShortA ), "" );
+  EXPECT_EQ( parsed.optionsByKey.at( DenseEnum::eShortB ).occurrences.size(), 2 );
+  EXPECT_THROW( parsed.optionsByKey.at( DenseEnum::eShortA ), std::out_of_range );
+
+  // Iteration visits only the present keys, in key order.
+  std::vector<DenseEnum> keys;
+  for ( const auto& [key, option] : parsed.optionsByKey )
+  {
+    keys.push_back( key );
+  }
+  EXPECT_EQ( keys, ( std::vector<DenseEnum>{ DenseEnum::eShortB, DenseEnum::eLongA, DenseEnum::eLongB } ) );
+  EXPECT_EQ( parsed.optionsByKey.size(), 3 );
+
+  // Copies are independent and an erased key reads as absent.
+  const auto copy{ parsed };
+  EXPECT_EQ( parsed.optionsByKey.erase( DenseEnum::eShortB ), 1 );
+  EXPECT_FALSE( parsed.isPresent( DenseEnum::eShortB ) );
+  EXPECT_EQ( copy.getLatestValue( DenseEnum::eShortB ), "b2" );
+
+  // Moving takes the entries whole and the map moved from can be used again.
+  auto moved{ std::move( parsed ) };
+  EXPECT_EQ( moved.getLatestValue( DenseEnum::eLongB ), "lb" );
+  EXPECT_TRUE( parsed.optionsByKey.empty() );
+  EXPECT_FALSE( parsed.isPresent( DenseEnum::eLongB ) );
+  parsed = moved;
+  EXPECT_EQ( parsed.getLatestValue( DenseEnum::eLongB ), "lb" );
+
+  // Reparsing reuses the entries without leaving anything behind.
+  const char* argv2[2]{ { "exe2" }, { "-a" } };
+  options.parseInto( parsed, 2, const_cast<char**>( argv2 ) );
+  EXPECT_TRUE( parsed.isPresent( DenseEnum::eShortA ) );
+  EXPECT_FALSE( parsed.isPresent( DenseEnum::eLongB ) );
+  ASSERT_EQ( parsed.optionsByKey.at( DenseEnum::eLongA ).occurrences.size(), 1 );
+  EXPECT_EQ( parsed.optionsByArgvPosition.size(), 1 );
+
+  // A view and a pmr result pick up the dense map just the same.
+  const auto view{ options.parseView( 7, const_cast<char**>( argv ) ) };
+  EXPECT_EQ( view.getLatestValue( DenseEnum::eLongB ), "lb" );
+
+  std::pmr::monotonic_buffer_resource arena;
+  const auto pmrParsed{ options.parse( 7, const_cast<char**>( argv ), &arena ) };
+  EXPECT_EQ( pmrParsed.getLatestValue( DenseEnum::eShortB ), "b2" );
+  EXPECT_EQ( pmrParsed.optionsByKey.at( DenseEnum::eShortB ).occurrences.get_allocator().resource(), &arena );
+}
+
+
+void testDenseMisconfigured()
+{
+  EXPECT_THROW( ( lb::options::Options<DenseEnum>
+                  {
+                    { DenseEnum::eShortA    , 'a', {}, 0, 0, "In range." },
+                    { DenseEnum::eOutOfRange, 'o', {}, 0, 0, "Outside the EnumCount." },
+                  } ), std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, DenseMap)
+{
+  testDenseParse();
+  testDenseMisconfigured();
+}
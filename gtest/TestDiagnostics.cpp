@@ -0,0 +1,173 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <lb/options/Options.h>
+#include <lb/options/ParseError.h>
+
+
+namespace
+{
+
+
+enum class DiagnosticsEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+const lb::options::Options<DiagnosticsEnum>& getOptions()
+{
+  static const lb::options::Options<DiagnosticsEnum> options
+  {
+    { DiagnosticsEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+    { DiagnosticsEnum::eShortB, 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+    { DiagnosticsEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+    { DiagnosticsEnum::eLongB , '\0', "long-option-b", 2,  2, "A long option that requires two arguments." },
+  };
+  return options;
+}
+
+
+void testDiagnoseClean()
+{
+  const char* argv[4]{ { "exe" }, { "-a" }, { "--long-option-a" }, { "x" } };
+  lb::options::ParsedOptions<DiagnosticsEnum> parsed;
+  lb::options::ParseDiagnostics<DiagnosticsEnum> diagnostics;
+  EXPECT_TRUE( getOptions().diagnose( parsed, diagnostics, 4, const_cast<char**>( argv ) ) );
+  EXPECT_TRUE( diagnostics.empty() );
+  EXPECT_EQ( parsed.getLatestValue( DiagnosticsEnum::eLongA ), "x" );
+}
+
+
+void testDiagnoseEveryError()
+{
+  using lb::options::ParseErrorCode;
+
+  const char* argv[12]
+  {
+    { "exe" },
+    { "-axa" },                   // unknown short at offset 2
+    { "--long-option-b" },        // too few, cut short by the next flag
+    { "1" },
+    { "--no-such" },              // unknown long, its value is skipped
+    { "ignored" },
+    { "-b" },
+    { "2" },
+    { "--long-option-a" },        // too many
+    { "3" },
+    { "4" },
+    { "-y" },                     // unknown short at offset 1
+  };
+  lb::options::ParsedOptions<DiagnosticsEnum> parsed;
+  lb::options::ParseDiagnostics<DiagnosticsEnum> diagnostics;
+  EXPECT_FALSE( getOptions().diagnose( parsed, diagnostics, 12, const_cast<char**>( argv ) ) );
+
+  const auto& records{ diagnostics.getRecords() };
+  ASSERT_EQ( records.size(), 5 );
+
+  EXPECT_EQ( records[0].error.code, ParseErrorCode::eUnknownShortOption );
+  EXPECT_EQ( records[0].error.argvIndex, 1 );
+  EXPECT_EQ( records[0].error.characterOffset, 2 );
+  EXPECT_EQ( records[0].error.flag, "x" );
+  EXPECT_EQ( records[0].key, nullptr );
+
+  // In the order found, so the flag that cuts an option short comes first.
+  EXPECT_EQ( records[1].error.code, ParseErrorCode::eUnknownLongOption );
+  EXPECT_EQ( records[1].error.argvIndex, 4 );
+  EXPECT_EQ( records[1].error.flag, "no-such" );
+
+  EXPECT_EQ( records[2].error.code, ParseErrorCode::eTooFewValues );
+  EXPECT_EQ( records[2].error.argvIndex, 2 );
+  ASSERT_NE( records[2].key, nullptr );
+  EXPECT_EQ( *records[2].key, DiagnosticsEnum::eLongB );
+
+  EXPECT_EQ( records[3].error.code, ParseErrorCode::eUnknownShortOption );
+  EXPECT_EQ( records[3].error.argvIndex, 11 );
+  EXPECT_EQ( records[3].error.characterOffset, 1 );
+
+  EXPECT_EQ( records[4].error.code, ParseErrorCode::eTooManyValues );
+  EXPECT_EQ( records[4].error.argvIndex, 8 );
+  ASSERT_NE( records[4].key, nullptr );
+  EXPECT_EQ( *records[4].key, DiagnosticsEnum::eLongA );
+
+  // What could be parsed still was, and the skipped value went nowhere.
+  EXPECT_EQ( parsed.getLatestValue( DiagnosticsEnum::eShortB ), "2" );
+  EXPECT_TRUE( parsed.trailingValues.empty() );
+
+  // The first error is the one the throwing parse reports.
+  EXPECT_EQ( getOptions().tryParse( 12, const_cast<char**>( argv ) ).getError().argvIndex, 1 );
+
+  EXPECT_EQ( diagnostics.describe().substr( 0, 32 ), "argv[1]: Unknown short option x\n" );
+}
+
+
+void testDiagnoseCapacity()
+{
+  std::vector<std::string> args{ "exe" };
+  for ( int i = 0; i < 10000; ++i )
+  {
+    args.push_back( "--bad" + std::to_string( i ) );
+  }
+  std::vector<char*> argv;
+  for ( auto& arg : args )
+  {
+    argv.push_back( arg.data() );
+  }
+
+  lb::options::ParsedOptions<DiagnosticsEnum> parsed;
+  lb::options::ParseDiagnostics<DiagnosticsEnum> diagnostics{ 16 };
+  EXPECT_FALSE( getOptions().diagnose( parsed, diagnostics, static_cast<int>( argv.size() ), argv.data() ) );
+  EXPECT_EQ( diagnostics.getRecords().size(), 16 );
+  EXPECT_EQ( diagnostics.getRecords().capacity(), 16 );
+  EXPECT_EQ( diagnostics.getNumDropped(), 10000 - 16 );
+  EXPECT_EQ( diagnostics.size(), 10000 );
+  EXPECT_EQ( diagnostics.getRecords().back().error.flag, "bad15" );
+
+  // Cleared on reuse.
+  const char* good[2]{ { "exe" }, { "-a" } };
+  EXPECT_TRUE( getOptions().diagnose( parsed, diagnostics, 2, const_cast<char**>( good ) ) );
+  EXPECT_EQ( diagnostics.size(), 0 );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, Diagnostics)
+{
+  testDiagnoseClean();
+  testDiagnoseEveryError();
+  testDiagnoseCapacity();
+}
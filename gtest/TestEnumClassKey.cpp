@@ -27,6 +27,9 @@
 
 #include <gtest/gtest.h>
 
+#include <iterator>
+#include <vector>
+
 #include <lb/options/Options.h>
 
 
@@ -1379,6 +1382,38 @@ void testGetLatestValue()
   EXPECT_EQ( parsed.getLatestValue( OptionEnum::eLongE ), "1.e-16" );
 }
 
+void testRuntimeDefinitions()
+{
+  using Definitions = std::vector< lb::options::KeyedOptionDefinition<OptionEnum> >;
+  Definitions definitions
+  {
+    { OptionEnum::eShortA, 'a' , {}              , 0, 0, "A short option that requires no arguments." },
+    { OptionEnum::eLongC , '\0' , "long-option-c", 1, 1, "A long option that requires a single argument with a default.", { "bob" } },
+  };
+
+  // Copied from a range of const definitions.
+  const lb::options::Options<OptionEnum> copied{ definitions.cbegin(), definitions.cend() };
+  EXPECT_EQ( copied.getDefinition( OptionEnum::eLongC ).description, definitions[1].option.description );
+
+  // Moved, so the strings are the very same buffers.
+  const char* const description{ definitions[1].option.description.data() };
+  const lb::options::Options<OptionEnum> moved{ std::move( definitions ) };
+  EXPECT_EQ( moved.getDefinition( OptionEnum::eLongC ).description.data(), description );
+
+  const char* argv[3]{ { "exe" }, { "-a" }, { "--long-option-c" } };
+  EXPECT_EQ( moved.parse( 2, const_cast<char**>( argv ) ).getLatestValue( OptionEnum::eLongC ), "bob" );
+
+  // Definitions are checked however they arrive.
+  Definitions misconfigured
+  {
+    { OptionEnum::eShortA, 'a', {}, 0, 0, "A short option." },
+    { OptionEnum::eShortB, 'a', {}, 0, 0, "The same short option." },
+  };
+  EXPECT_THROW( ( lb::options::Options<OptionEnum>{ std::make_move_iterator( misconfigured.begin() )
+                                                  , std::make_move_iterator( misconfigured.end() ) } )
+              , std::runtime_error );
+}
+
 TEST(Options, EnumClassKey)
 {
   testMisconfiguredOptions1();
@@ -1426,4 +1461,5 @@ TEST(Options, EnumClassKey)
   testIsPresent();
   testIsNotPresent();
   testGetLatestValue();
+  testRuntimeDefinitions();
 }
@@ -0,0 +1,128 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class EnvironmentEnum
+{
+  eFlag,
+  eSingle,
+  eMultiple,
+  eExplicit,
+  eShortOnly,
+};
+
+
+lb::options::Options<EnvironmentEnum> makeOptions()
+{
+  lb::options::Options<EnvironmentEnum>::Configuration config;
+  config.environmentPrefix = "LB_OPTIONS_TEST_";
+  return
+  {
+    {
+      { EnvironmentEnum::eFlag     , 'f' , "flag"        , 0,  0, "A flag." },
+      { EnvironmentEnum::eSingle   , '\0', "log.level"   , 1,  1, "A single value with a default.", { "info" } },
+      { EnvironmentEnum::eMultiple , '\0', "include-dirs", 1,  3, "Up to three values." },
+      { EnvironmentEnum::eExplicit , 'e' , "explicit"    , 1,  1, "Bound by name.", {}, "LB_OPTIONS_TEST_OTHER" },
+      { EnvironmentEnum::eShortOnly, 's' , {}            , 1,  1, "Not bound at all." },
+    }
+  , config };
+}
+
+
+void testEnvironment()
+{
+  EXPECT_EQ( lb::options::environmentVariableName( "APP_", "log-level.x" ), "APP_LOG_LEVEL_X" );
+
+  const auto options{ makeOptions() };
+  const char* argv[3]{ { "exe" }, { "--explicit" }, { "from-argv" } };
+
+  // Nothing set so only the defaults.
+  auto parsed{ options.parse( 1, const_cast<char**>( argv ) ) };
+  EXPECT_FALSE( parsed.isPresent( EnvironmentEnum::eFlag ) );
+  EXPECT_EQ( parsed.getLatestValue( EnvironmentEnum::eSingle ), "info" );
+
+  ::setenv( "LB_OPTIONS_TEST_FLAG", "", 1 );
+  ::setenv( "LB_OPTIONS_TEST_LOG_LEVEL", "debug with spaces", 1 );
+  ::setenv( "LB_OPTIONS_TEST_INCLUDE_DIRS", " a\tb  c ", 1 );
+  ::setenv( "LB_OPTIONS_TEST_OTHER", "from-environment", 1 );
+  ::setenv( "LB_OPTIONS_TEST_EXPLICIT", "not-bound", 1 );
+
+  parsed = options.parse( 1, const_cast<char**>( argv ) );
+  EXPECT_TRUE( parsed.isPresent( EnvironmentEnum::eFlag ) );
+  EXPECT_EQ( parsed.getLatestValue( EnvironmentEnum::eSingle ), "debug with spaces" ); // Over the default
+  EXPECT_EQ( parsed.optionsByKey.at( EnvironmentEnum::eMultiple ).occurrences.front().values
+           , ( std::vector<std::string>{ "a", "b", "c" } ) );
+  EXPECT_EQ( parsed.getLatestValue( EnvironmentEnum::eExplicit ), "from-environment" );
+  EXPECT_FALSE( parsed.isPresent( EnvironmentEnum::eShortOnly ) );
+  EXPECT_TRUE( parsed.optionsByArgvPosition.empty() );
+
+  // The command line wins.
+  parsed = options.parse( 3, const_cast<char**>( argv ) );
+  EXPECT_EQ( parsed.optionsByKey.at( EnvironmentEnum::eExplicit ).occurrences.size(), 1 );
+  EXPECT_EQ( parsed.getLatestValue( EnvironmentEnum::eExplicit ), "from-argv" );
+
+  // Value counts are checked as on the command line.
+  ::setenv( "LB_OPTIONS_TEST_INCLUDE_DIRS", "a b c d", 1 );
+  EXPECT_THROW( options.parse( 1, const_cast<char**>( argv ) ), std::runtime_error );
+  ::setenv( "LB_OPTIONS_TEST_INCLUDE_DIRS", "  ", 1 );
+  EXPECT_THROW( options.parse( 1, const_cast<char**>( argv ) ), std::runtime_error );
+
+  for ( const char* variable : { "LB_OPTIONS_TEST_FLAG", "LB_OPTIONS_TEST_LOG_LEVEL", "LB_OPTIONS_TEST_INCLUDE_DIRS"
+                               , "LB_OPTIONS_TEST_OTHER", "LB_OPTIONS_TEST_EXPLICIT" } )
+  {
+    ::unsetenv( variable );
+  }
+
+  // Binding one variable to two options is a misconfiguration.
+  EXPECT_THROW( ( lb::options::Options<EnvironmentEnum>
+                  {
+                    { EnvironmentEnum::eFlag  , 'f', {}, 0, 0, "", {}, "LB_OPTIONS_TEST_SAME" },
+                    { EnvironmentEnum::eSingle, 'g', {}, 0, 0, "", {}, "LB_OPTIONS_TEST_SAME" },
+                  } )
+              , std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, Environment)
+{
+  testEnvironment();
+}
@@ -0,0 +1,192 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <lb/options/FlagTrie.h>
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class TrieEnum
+{
+  eVerbose,
+  eVersion,
+  eVerb,
+  eDbHost,
+  eDbPort,
+  eDbPoolSize,
+  eDebug,
+  eQuiet,
+};
+
+
+std::vector<lb::options::FlagTrie::Index> withPrefix( const lb::options::FlagTrie& trie
+                                                    , std::string_view prefix )
+{
+  std::vector<lb::options::FlagTrie::Index> found;
+  trie.forEachWithPrefix( prefix, [&found]( lb::options::FlagTrie::Index i ) { found.push_back( i ); } );
+  return found;
+}
+
+void testFlagTrieLookups()
+{
+  using Trie = lb::options::FlagTrie;
+  const Trie trie{ { { "verbose", 0 }, { "version", 1 }, { "verb", 2 }
+                   , { "db.host", 3 }, { "db.port", 4 }, { "db.pool-size", 5 }
+                   , { "debug", 6 }, { "quiet", 7 } } };
+
+  EXPECT_EQ( trie.size(), 8 );
+
+  EXPECT_EQ( trie.find( "verbose" )     , 0 );
+  EXPECT_EQ( trie.find( "version" )     , 1 );
+  EXPECT_EQ( trie.find( "verb" )        , 2 );
+  EXPECT_EQ( trie.find( "db.pool-size" ), 5 );
+  EXPECT_EQ( trie.find( "quiet" )       , 7 );
+  EXPECT_EQ( trie.find( "" )            , Trie::None );
+  EXPECT_EQ( trie.find( "ver" )         , Trie::None );
+  EXPECT_EQ( trie.find( "verbosely" )   , Trie::None );
+  EXPECT_EQ( trie.find( "db.po" )       , Trie::None );
+  EXPECT_EQ( trie.find( "x" )           , Trie::None );
+
+  // Exact matches win over abbreviations, ambiguous prefixes resolve to nothing.
+  EXPECT_EQ( trie.findUnambiguous( "verb" )   , 2 );
+  EXPECT_EQ( trie.findUnambiguous( "verbo" )  , 0 );
+  EXPECT_EQ( trie.findUnambiguous( "vers" )   , 1 );
+  EXPECT_EQ( trie.findUnambiguous( "ver" )    , Trie::None );
+  EXPECT_EQ( trie.findUnambiguous( "q" )      , 7 );
+  EXPECT_EQ( trie.findUnambiguous( "de" )     , 6 );
+  EXPECT_EQ( trie.findUnambiguous( "d" )      , Trie::None );
+  EXPECT_EQ( trie.findUnambiguous( "db.po" )  , Trie::None );
+  EXPECT_EQ( trie.findUnambiguous( "db.por" ) , 4 );
+  EXPECT_EQ( trie.findUnambiguous( "quieter" ), Trie::None );
+
+  EXPECT_EQ( withPrefix( trie, "db." ), ( std::vector<Trie::Index>{ 3, 5, 4 } ) );
+  EXPECT_EQ( withPrefix( trie, "db.p" ), ( std::vector<Trie::Index>{ 5, 4 } ) );
+  EXPECT_EQ( withPrefix( trie, "ver" ), ( std::vector<Trie::Index>{ 2, 0, 1 } ) );
+  EXPECT_EQ( withPrefix( trie, "verb" ), ( std::vector<Trie::Index>{ 2, 0 } ) );
+  EXPECT_EQ( withPrefix( trie, "z" ), ( std::vector<Trie::Index>{} ) );
+  EXPECT_EQ( withPrefix( trie, "" ).size(), 8 );
+
+  EXPECT_THROW( Trie( { { "aaa", 0 }, { "bbb", 1 }, { "aaa", 2 } } ), std::runtime_error );
+
+  const Trie empty;
+  EXPECT_EQ( empty.find( "a" ), Trie::None );
+  EXPECT_EQ( empty.findUnambiguous( "a" ), Trie::None );
+  EXPECT_TRUE( withPrefix( empty, "" ).empty() );
+}
+
+void testFlagTrieMany()
+{
+  // Lots of dotted flags sharing prefixes at several levels.
+  std::vector<std::string> flags;
+  for ( int i = 0; i < 40; ++i )
+  {
+    for ( int j = 0; j < 25; ++j )
+    {
+      flags.push_back( "section" + std::to_string( i ) + ".key" + std::to_string( j ) );
+    }
+  }
+  std::vector<lb::options::FlagTrie::Entry> entries;
+  for ( std::size_t i = 0; i < flags.size(); ++i )
+  {
+    entries.push_back( { flags[i], static_cast<lb::options::FlagTrie::Index>( i ) } );
+  }
+  const lb::options::FlagTrie trie{ entries };
+
+  for ( std::size_t i = 0; i < flags.size(); ++i )
+  {
+    ASSERT_EQ( trie.find( flags[i] ), i ) << flags[i];
+  }
+  EXPECT_EQ( withPrefix( trie, "section1." ).size(), 25 );
+  EXPECT_EQ( withPrefix( trie, "section1" ).size(), 11 * 25 );
+  EXPECT_EQ( withPrefix( trie, "section39.key2" ).size(), 6 );
+  EXPECT_EQ( trie.findUnambiguous( "section39.key24" ), 39 * 25 + 24 );
+  EXPECT_EQ( trie.findUnambiguous( "section39.key2" ), 39 * 25 + 2 );
+  EXPECT_EQ( trie.findUnambiguous( "section39.key" ), lb::options::FlagTrie::None );
+}
+
+void testOptionsAbbreviations()
+{
+  const std::initializer_list<lb::options::KeyedOptionDefinition<TrieEnum>> definitions
+  {
+    { TrieEnum::eVerbose   , 'v' , "verbose"     , 0, 0, "Be chatty." },
+    { TrieEnum::eVersion   , '\0', "version"     , 0, 0, "Print the version." },
+    { TrieEnum::eDbHost    , '\0', "db.host"     , 1, 1, "Database host." },
+    { TrieEnum::eDbPort    , '\0', "db.port"     , 1, 1, "Database port.", { "5432" } },
+    { TrieEnum::eDbPoolSize, '\0', "db.pool-size", 1, 1, "Database pool size." },
+    { TrieEnum::eQuiet     , 'q' , {}            , 0, 0, "A short only option." },
+  };
+
+  const char* argv[6]
+  {
+    { "exe" },
+    { "--verbo" },
+    { "--db.h" }, { "localhost" },
+    { "--db.poo" }, { "8" },
+  };
+
+  const lb::options::Options<TrieEnum> strict{ definitions };
+  EXPECT_THROW( strict.parse( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ), std::runtime_error );
+
+  const lb::options::Options<TrieEnum> abbreviating{ definitions, { true, true } };
+  lb::options::ParsedOptions<TrieEnum> parsed;
+  ASSERT_NO_THROW( parsed = abbreviating.parse( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ) );
+  EXPECT_TRUE( parsed.isPresent( TrieEnum::eVerbose ) );
+  EXPECT_FALSE( parsed.isPresent( TrieEnum::eVersion ) );
+  EXPECT_EQ( parsed.getLatestValue( TrieEnum::eDbHost ), "localhost" );
+  EXPECT_EQ( parsed.getLatestValue( TrieEnum::eDbPoolSize ), "8" );
+  EXPECT_EQ( parsed.getLatestValue( TrieEnum::eDbPort ), "5432" );
+
+  const char* ambiguousArgv[2]{ { "exe" }, { "--ver" } };
+  EXPECT_THROW( abbreviating.parse( 2, const_cast<char**>( ambiguousArgv ) ), std::runtime_error );
+
+  // Options with no long flag cannot be reached with an empty one.
+  const char* emptyArgv[2]{ { "exe" }, { "--" } };
+  EXPECT_THROW( abbreviating.parse( 2, const_cast<char**>( emptyArgv ) ), std::runtime_error );
+
+  std::vector<TrieEnum> db;
+  abbreviating.forEachWithPrefix( "db.", [&db]( const auto& definition ) { db.push_back( definition.key ); } );
+  EXPECT_EQ( db, ( std::vector<TrieEnum>{ TrieEnum::eDbHost, TrieEnum::eDbPoolSize, TrieEnum::eDbPort } ) );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, FlagTrie)
+{
+  testFlagTrieLookups();
+  testFlagTrieMany();
+  testOptionsAbbreviations();
+}
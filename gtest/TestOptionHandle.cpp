@@ -0,0 +1,123 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string_view>
+
+#include <lb/options/ConstexprOptions.h>
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class HandleEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+void testHandle()
+{
+  const lb::options::Options<HandleEnum> options
+  {
+    { HandleEnum::eShortA, 'a' , {}             , 0, 0, "A short option that requires no arguments." },
+    { HandleEnum::eShortB, 'b' , {}             , 1, 3, "A short option that requires one to three arguments." },
+    { HandleEnum::eLongA , '\0', "long-option-a", 1, 1, "A long option with a default.", { "default-a" } },
+    { HandleEnum::eLongB , '\0', "long-option-b", 1, 1, "A long option that requires a single argument." },
+  };
+
+  const auto a{ options.handle( HandleEnum::eShortA ) };
+  const auto b{ options.handle( HandleEnum::eShortB ) };
+  const auto longA{ options.handle( HandleEnum::eLongA ) };
+  const auto longB{ options.handle( HandleEnum::eLongB ) };
+  EXPECT_THROW( options.handle( static_cast<HandleEnum>( 42 ) ), std::runtime_error );
+
+  const char* argv[6]{ { "exe" }, { "-ab" }, { "b1" }, { "b2" }, { "-b" }, { "b3" } };
+  auto parsed{ std::make_unique<lb::options::ParsedOptions<HandleEnum>>(
+                 options.parse( 6, const_cast<char**>( argv ) ) ) };
+
+  ASSERT_NE( parsed->get( a ), nullptr );
+  EXPECT_EQ( parsed->get( a ), &parsed->optionsByKey.at( HandleEnum::eShortA ) );
+  EXPECT_EQ( parsed->get( b )->occurrences.size(), 2 );
+  EXPECT_EQ( parsed->get( longB ), nullptr );
+  EXPECT_EQ( parsed->getLatestValue( b ), "b3" );
+  EXPECT_EQ( parsed->getLatestValue( longA ), "default-a" );
+  EXPECT_EQ( parsed->getLatestValue( longB ), "" );
+  EXPECT_EQ( parsed->getLatestValue( a ), "" );
+
+  // No copy, the view refers into the result.
+  const std::string_view latest{ parsed->getLatestValue( b ) };
+  EXPECT_EQ( latest.data(), parsed->get( b )->occurrences.back().values.back().data() );
+
+  // Copies and moves look up their own entries.
+  const auto copy{ *parsed };
+  auto moved{ std::move( *parsed ) };
+  parsed.reset();
+  EXPECT_EQ( copy.get( b ), &copy.optionsByKey.at( HandleEnum::eShortB ) );
+  EXPECT_EQ( copy.getLatestValue( b ), "b3" );
+  EXPECT_EQ( moved.get( b ), &moved.optionsByKey.at( HandleEnum::eShortB ) );
+  EXPECT_EQ( moved.getLatestValue( longA ), "default-a" );
+
+  // As does a result parsed into again.
+  const char* argv2[3]{ { "exe" }, { "--long-option-b" }, { "lb" } };
+  options.parseInto( moved, 3, const_cast<char**>( argv2 ) );
+  EXPECT_EQ( moved.get( b ), nullptr );
+  EXPECT_EQ( moved.getLatestValue( longB ), "lb" );
+}
+
+
+void testConstexprHandle()
+{
+  static constexpr auto options{ lb::options::makeConstexprOptions<HandleEnum>(
+  {
+    { HandleEnum::eShortA, { 'a' , {}             , 0, 0, "A short option." } },
+    { HandleEnum::eLongB , { '\0', "long-option-b", 1, 1, "A long option." } },
+  } ) };
+  static constexpr auto longB{ options.handle( HandleEnum::eLongB ) };
+  static_assert( longB.slot == 1 );
+
+  const char* argv[3]{ { "exe" }, { "--long-option-b" }, { "lb" } };
+  const auto parsed{ options.parseView( 3, const_cast<char**>( argv ) ) };
+  EXPECT_EQ( parsed.getLatestValue( longB ), "lb" );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, OptionHandle)
+{
+  testHandle();
+  testConstexprHandle();
+}
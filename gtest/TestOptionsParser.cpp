@@ -0,0 +1,148 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include <lb/options/OptionsParser.h>
+
+
+namespace
+{
+
+
+enum class StreamEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+const lb::options::Options<StreamEnum>& getOptions()
+{
+  static const lb::options::Options<StreamEnum> options
+  {
+    { StreamEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+    { StreamEnum::eShortB, 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+    { StreamEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+    { StreamEnum::eLongB , '\0', "long-option-b", 1,  1, "A long option that requires a single argument." },
+  };
+  return options;
+}
+
+
+void testFeed()
+{
+  lb::options::OptionsParser<StreamEnum> parser{ getOptions(), "exe" };
+
+  // Arguments arriving one per line, each gone as soon as it is fed.
+  std::istringstream stream{ "-a\n--long-option-b\na value long enough to need an allocation\n-b\n" };
+  std::string line;
+  while ( std::getline( stream, line ) )
+  {
+    parser.feed( line );
+    line.assign( line.size(), 'X' );
+  }
+  for ( int i = 0; i < 1000; ++i )
+  {
+    parser.feed( std::to_string( i ) );
+  }
+  EXPECT_EQ( parser.getNumFed(), 1004 );
+  EXPECT_FALSE( parser.getParsed().isPresent( StreamEnum::eLongA ) );
+
+  const auto& parsed{ parser.finish() };
+  EXPECT_EQ( parsed.executable, "exe" );
+  EXPECT_TRUE( parsed.isPresent( StreamEnum::eShortA ) );
+  EXPECT_EQ( parsed.getLatestValue( StreamEnum::eLongB ), "a value long enough to need an allocation" );
+  EXPECT_EQ( parsed.optionsByKey.at( StreamEnum::eShortB ).occurrences.front().values.size(), 1000 );
+  EXPECT_EQ( parsed.getLatestValue( StreamEnum::eShortB ), "999" );
+  EXPECT_EQ( parsed.getLatestValue( StreamEnum::eLongA ), "default-a" );
+  EXPECT_EQ( parser.getNumFed(), 1004 );
+
+  EXPECT_THROW( parser.feed( "-a" ), std::runtime_error );
+  EXPECT_THROW( parser.finish(), std::runtime_error );
+
+  // Same as parse once reset.
+  const char* argv[4]{ { "exe2" }, { "--long-option-a" }, { "aaa" }, { "trailing" } };
+  parser.reset( argv[0] );
+  for ( int i = 1; i < 4; ++i )
+  {
+    parser.feed( argv[i] );
+  }
+  const auto& reparsed{ parser.finish() };
+  const auto expected{ getOptions().parse( 4, const_cast<char**>( argv ) ) };
+  EXPECT_EQ( reparsed.executable, expected.executable );
+  EXPECT_FALSE( reparsed.isPresent( StreamEnum::eShortA ) );
+  EXPECT_EQ( reparsed.getLatestValue( StreamEnum::eLongA ), expected.getLatestValue( StreamEnum::eLongA ) );
+  EXPECT_EQ( reparsed.trailingValues, expected.trailingValues );
+  EXPECT_EQ( reparsed.optionsByKey.size(), expected.optionsByKey.size() );
+}
+
+
+void testFeedErrors()
+{
+  lb::options::OptionsParser<StreamEnum> parser{ getOptions() };
+
+  // Reported as soon as the argument is fed.
+  parser.feed( "-a" );
+  EXPECT_THROW( parser.feed( "--no-such-option" ), std::runtime_error );
+
+  parser.reset();
+  parser.feed( "--long-option-b" );
+  EXPECT_THROW( parser.feed( "-a" ), std::runtime_error );
+
+  // Or at the end.
+  parser.reset();
+  parser.feed( "--long-option-b" );
+  EXPECT_THROW( parser.finish(), std::runtime_error );
+
+  lb::options::Options<StreamEnum>::Configuration config;
+  config.allowTrailingValues = false;
+  const lb::options::Options<StreamEnum> strict
+  {
+    { { StreamEnum::eLongB, '\0', "long-option-b", 1, 1, "A long option that requires a single argument." } }
+  , config };
+  lb::options::OptionsParser<StreamEnum> strictParser{ strict };
+  strictParser.feed( "--long-option-b" );
+  strictParser.feed( "b" );
+  strictParser.feed( "excess" );
+  EXPECT_THROW( strictParser.finish(), std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, OptionsParser)
+{
+  testFeed();
+  testFeedErrors();
+}
@@ -0,0 +1,236 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <lb/options/ParseBatch.h>
+#include <lb/options/ThreadPool.h>
+
+
+// Run under ThreadSanitizer with "make tsan" to check that concurrent parses
+// against one Options instance do not race.
+namespace
+{
+
+
+enum class BatchEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+lb::options::Options<BatchEnum> makeOptions( bool usePerfectHash )
+{
+  lb::options::Options<BatchEnum>::Configuration config;
+  config.allowAbbreviations = true;
+  config.usePerfectHash = usePerfectHash;
+  return
+  {
+    {
+      { BatchEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+      { BatchEnum::eShortB, 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+      { BatchEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+      { BatchEnum::eLongB , '\0', "long-option-b", 1,  1, "A long option that requires a single argument." },
+    }
+  , config };
+}
+
+
+// Line i is valid unless i is a multiple of 7, when it has an unknown flag.
+std::vector< std::vector<std::string> > makeLines( std::size_t numLines )
+{
+  std::vector< std::vector<std::string> > lines( numLines );
+  for ( std::size_t i = 0; i < numLines; ++i )
+  {
+    const std::string I{ std::to_string( i ) };
+    lines[i] = { "exe" + I, "-a", "--long-option-b", I, "-b", "x", "y", "--long-option-a", "z" + I };
+    if ( i % 7 == 0 )
+    {
+      lines[i].push_back( "--no-such-option" );
+    }
+  }
+  return lines;
+}
+
+
+void testParseBatch()
+{
+  const auto options{ makeOptions( false ) };
+  const auto lines{ makeLines( 1000 ) };
+
+  lb::options::ThreadPool pool{ 4 };
+  const auto results{ lb::options::parseBatch( options, lines, pool, 5 ) };
+  ASSERT_EQ( results.size(), lines.size() );
+  for ( std::size_t i = 0; i < lines.size(); ++i )
+  {
+    if ( i % 7 == 0 )
+    {
+      EXPECT_FALSE( results[i].parsed );
+      EXPECT_FALSE( results[i].error.empty() );
+      continue;
+    }
+    ASSERT_TRUE( results[i].parsed );
+    const auto& parsed{ *results[i].parsed };
+    EXPECT_EQ( parsed.executable, lines[i][0] );
+    EXPECT_TRUE( parsed.isPresent( BatchEnum::eShortA ) );
+    EXPECT_EQ( parsed.getLatestValue( BatchEnum::eLongB ), lines[i][3] );
+    EXPECT_EQ( parsed.getLatestValue( BatchEnum::eShortB ), "y" );
+    EXPECT_EQ( parsed.getLatestValue( BatchEnum::eLongA ), lines[i][8] );
+  }
+
+  // Any executor will do, including running the task straight away, as will
+  // lines of C strings.
+  std::vector< std::vector<const char*> > cLines{ { "exe", "-a" }, {}, { "exe", "-b" } };
+  const auto inlineResults{ lb::options::parseBatch( options, cLines, []( std::function<void()> task ){ task(); } ) };
+  EXPECT_TRUE( inlineResults[0].parsed );
+  EXPECT_FALSE( inlineResults[1].parsed );
+  EXPECT_FALSE( inlineResults[2].parsed );
+
+  // An exception from the callback stops the batch and is passed on.
+  std::atomic<int> numCalls{ 0 };
+  EXPECT_THROW( lb::options::forEachParsed( options
+                                          , lines
+                                          , [ &numCalls ]( std::size_t, const auto*, const auto* )
+                                            {
+                                              if ( ++numCalls == 10 )
+                                              {
+                                                throw std::logic_error{ "stop" };
+                                              }
+                                            }
+                                          , pool
+                                          , 5 )
+              , std::logic_error );
+  EXPECT_LT( numCalls, 1000 );
+
+  // As is one from the executor, once the tasks it did accept have finished.
+  std::atomic<bool> returned{ false };
+  std::atomic<bool> calledLate{ false };
+  {
+    lb::options::ThreadPool failingPool{ 2 };
+    int numSubmitted{ 0 };
+    EXPECT_THROW( lb::options::forEachParsed( options
+                                            , lines
+                                            , [ & ]( std::size_t, const auto*, const auto* )
+                                              {
+                                                if ( returned )
+                                                {
+                                                  calledLate = true;
+                                                }
+                                              }
+                                            , [ & ]( std::function<void()> task )
+                                              {
+                                                if ( ++numSubmitted == 3 )
+                                                {
+                                                  throw std::length_error{ "full" };
+                                                }
+                                                failingPool( std::move( task ) );
+                                              }
+                                            , 5 )
+                , std::length_error );
+    returned = true;
+  }
+  EXPECT_FALSE( calledLate );
+}
+
+
+// Many threads hammering every const parse entry point of shared instances.
+void testConcurrentParse()
+{
+  const auto hashed{ makeOptions( false ) };
+  const auto perfect{ makeOptions( true ) };
+  const auto lines{ makeLines( 64 ) };
+
+  std::vector< std::vector<char*> > argvs;
+  for ( const auto& line : lines )
+  {
+    argvs.emplace_back();
+    for ( const auto& argument : line )
+    {
+      argvs.back().push_back( const_cast<char*>( argument.c_str() ) );
+    }
+  }
+
+  std::atomic<std::size_t> numParsed{ 0 };
+  std::atomic<std::size_t> numFailed{ 0 };
+  std::vector<std::thread> threads;
+  for ( int t = 0; t < 8; ++t )
+  {
+    threads.emplace_back( [ & ]
+    {
+      lb::options::ParsedOptions<BatchEnum> reused;
+      for ( int repeat = 0; repeat < 20; ++repeat )
+      {
+        for ( auto& argv : argvs )
+        {
+          const auto& options{ ( repeat % 2 ) ? perfect : hashed };
+          const int Argc{ static_cast<int>( argv.size() ) };
+          try
+          {
+            const auto parsed{ options.parse( Argc, argv.data() ) };
+            const auto view{ options.parseView( Argc, argv.data() ) };
+            options.parseInto( reused, Argc, argv.data() );
+            if ( ( parsed.getLatestValue( BatchEnum::eLongA ) == view.getLatestValue( BatchEnum::eLongA ) )
+              && ( reused.getLatestValue( BatchEnum::eLongA ) == view.getLatestValue( BatchEnum::eLongA ) ) )
+            {
+              ++numParsed;
+            }
+          }
+          catch ( const std::runtime_error& )
+          {
+            ++numFailed;
+          }
+        }
+      }
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ( numParsed, 8 * 20 * 54 );
+  EXPECT_EQ( numFailed, 8 * 20 * 10 );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ParseBatch)
+{
+  testParseBatch();
+  testConcurrentParse();
+}
@@ -0,0 +1,164 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <lb/options/ParseCache.h>
+
+
+namespace
+{
+
+
+enum class CacheEnum
+{
+  eShortA,
+  eShortB,
+  eShortC,
+  eLongA,
+  eLongB,
+};
+
+
+const lb::options::Options<CacheEnum>& getOptions()
+{
+  static const lb::options::Options<CacheEnum> options
+  {
+    { CacheEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+    { CacheEnum::eShortB, 'b' , {}             , 1,  3, "A short option that takes one to three arguments." },
+    { CacheEnum::eShortC, 'c' , {}             , 0,  1, "A short option with an optional argument." },
+    { CacheEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+    { CacheEnum::eLongB , '\0', "long-option-b", 1,  1, "A long option that requires a single argument." },
+  };
+  return options;
+}
+
+
+template< class Parsed >
+void expectSame( const Parsed& actual, const Parsed& expected, const std::string& line )
+{
+  SCOPED_TRACE( line );
+  EXPECT_EQ( actual.executable, expected.executable );
+  EXPECT_EQ( actual.trailingValues, expected.trailingValues );
+  ASSERT_EQ( actual.optionsByKey.size(), expected.optionsByKey.size() );
+  for ( const auto& [ key, option ] : expected.optionsByKey )
+  {
+    ASSERT_TRUE( actual.isPresent( key ) );
+    const auto& occurrences{ actual.optionsByKey.at( key ).occurrences };
+    ASSERT_EQ( occurrences.size(), option.occurrences.size() );
+    for ( std::size_t i = 0; i < occurrences.size(); ++i )
+    {
+      EXPECT_EQ( occurrences[i].values, option.occurrences[i].values );
+    }
+    EXPECT_EQ( actual.getLatestValue( getOptions().handle( key ) ), expected.getLatestValue( key ) );
+  }
+  ASSERT_EQ( actual.optionsByArgvPosition.size(), expected.optionsByArgvPosition.size() );
+  for ( std::size_t i = 0; i < actual.optionsByArgvPosition.size(); ++i )
+  {
+    EXPECT_EQ( actual.optionsByArgvPosition[i].positionIndex, expected.optionsByArgvPosition[i].positionIndex );
+    EXPECT_EQ( actual.optionsByArgvPosition[i].key, expected.optionsByArgvPosition[i].key );
+    EXPECT_EQ( actual.optionsByArgvPosition[i].occurrenceIndex, expected.optionsByArgvPosition[i].occurrenceIndex );
+  }
+}
+
+
+void testParseCache()
+{
+  // Each line shares a prefix with those before it, at all sorts of points in
+  // the parse.
+  const std::vector< std::vector<std::string> > lines
+  {
+    { "exe", "-a", "--long-option-b", "x", "-b", "1", "2", "t1", "t2" },
+    { "exe", "-a", "--long-option-b", "x", "-b", "1", "2", "t1", "t2" },
+    { "exe", "-a", "--long-option-b", "x", "-b", "1", "9", "3" },
+    { "exe", "-a", "--long-option-b", "x", "-b", "1" },
+    { "exe", "-a", "--long-option-b", "y", "-ab", "1", "2", "3", "t" },
+    { "exe", "-a", "--long-option-b", "y", "-ab", "1", "-c" },
+    { "exe", "-a", "--long-option-b", "y", "-ab", "1", "-c", "--long-option-a", "z" },
+    { "exe", "-a", "--long-option-b", "y", "-ab", "1", "-c", "c" },
+    { "exe", "t1", "t2", "t3" },
+    { "exe", "t1", "-b", "1" },
+    { "exe", "-a", "--long-option-b", "x", "-b", "1", "2", "t1", "t2" },
+  };
+
+  lb::options::ParseCache<CacheEnum> cache{ getOptions(), 2 };
+  for ( const auto& line : lines )
+  {
+    std::vector<char*> argv;
+    std::string joined;
+    for ( const auto& argument : line )
+    {
+      argv.push_back( const_cast<char*>( argument.c_str() ) );
+      joined += argument + " ";
+    }
+    const int Argc{ static_cast<int>( argv.size() ) };
+    expectSame( cache.parse( Argc, argv.data() ), getOptions().parse( Argc, argv.data() ), joined );
+  }
+
+  // A resume takes over the entry it resumed from, so the first line is long
+  // gone by the time it comes round again.
+  const auto& statistics{ cache.getStatistics() };
+  EXPECT_EQ( statistics.hits, 1 );
+  EXPECT_EQ( statistics.resumes, 8 );
+  EXPECT_EQ( statistics.misses, 2 );
+}
+
+
+void testParseCacheErrors()
+{
+  lb::options::ParseCache<CacheEnum> cache{ getOptions(), 1 };
+  const char* good[5]{ { "exe" }, { "-b" }, { "1" }, { "2" }, { "t" } };
+  const char* bad[4]{ { "exe" }, { "-b" }, { "1" }, { "-x" } };
+
+  cache.parse( 5, const_cast<char**>( good ) );
+  EXPECT_THROW( cache.parse( 4, const_cast<char**>( bad ) ), std::runtime_error );
+
+  // The failed parse is not mistaken for a cached one.
+  const auto& parsed{ cache.parse( 5, const_cast<char**>( good ) ) };
+  expectSame( parsed, getOptions().parse( 5, const_cast<char**>( good ) ), "good" );
+  EXPECT_EQ( cache.getStatistics().hits, 0 );
+  EXPECT_EQ( cache.getStatistics().misses, 2 );
+
+  cache.parse( 5, const_cast<char**>( good ) );
+  EXPECT_EQ( cache.getStatistics().hits, 1 );
+  cache.clear();
+  cache.parse( 5, const_cast<char**>( good ) );
+  EXPECT_EQ( cache.getStatistics().misses, 3 );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ParseCache)
+{
+  testParseCache();
+  testParseCacheErrors();
+}
@@ -0,0 +1,234 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class ParseEventsEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+  eBound,
+};
+
+
+lb::options::Options<ParseEventsEnum> makeOptions( bool allowTrailingValues )
+{
+  lb::options::Options<ParseEventsEnum>::Configuration config;
+  config.allowTrailingValues = allowTrailingValues;
+  return
+  {
+    {
+      { ParseEventsEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+      { ParseEventsEnum::eShortB, 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+      { ParseEventsEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+      { ParseEventsEnum::eLongB , '\0', "long-option-b", 2,  2, "A long option that requires two arguments." },
+      { ParseEventsEnum::eBound , '\0', "bound"        , 0,  2, "Bound to a variable.", {}, "LB_OPTIONS_TEST_EVENTS" },
+    }
+  , config };
+}
+
+
+// Writes each event as a line of text.
+struct RecordingHandler
+{
+  void onOption( ParseEventsEnum key, std::string_view flag, std::size_t argvIndex )
+  {
+    events.push_back( "option " + std::to_string( static_cast<int>( key ) ) + " " + std::string{ flag }
+                    + " " + std::to_string( argvIndex ) );
+  }
+
+  void onValue( ParseEventsEnum key, std::string_view value )
+  {
+    events.push_back( "value " + std::to_string( static_cast<int>( key ) ) + " " + std::string{ value } );
+  }
+
+  void onTrailing( std::string_view value )
+  {
+    events.push_back( "trailing " + std::string{ value } );
+  }
+
+  void onDefault( ParseEventsEnum key, const std::vector<std::string>& values )
+  {
+    events.push_back( "default " + std::to_string( static_cast<int>( key ) ) + " " + std::to_string( values.size() ) );
+  }
+
+  std::vector<std::string> events;
+};
+
+
+template< int N >
+std::vector<std::string> parseEvents( const lb::options::Options<ParseEventsEnum>& options, const char* (&argv)[N] )
+{
+  RecordingHandler handler;
+  options.parse( N, const_cast<char**>( argv ), handler );
+  return handler.events;
+}
+
+
+void testParseEvents()
+{
+  const auto options{ makeOptions( true ) };
+
+  const char* argv[10]{ { "exe" }, { "ignored" }, { "-a" }, { "-ab" }, { "1" }, { "2" }, { "--long-option-b" }, { "x" }, { "y" }, { "t" } };
+  const std::vector<std::string> expected
+  {
+    "option 0 a 2",
+    "option 0 a 3",
+    "option 1 b 3",
+    "value 1 1",
+    "value 1 2",
+    "option 3 long-option-b 6",
+    "value 3 x",
+    "value 3 y",
+    "trailing t",
+    "default 2 1",
+  };
+  EXPECT_EQ( parseEvents( options, argv ), expected );
+
+  // The same as the result parse gives.
+  const auto parsed{ options.parse( 10, const_cast<char**>( argv ) ) };
+  EXPECT_EQ( parsed.trailingValues, std::vector<std::string>{ "t" } );
+  EXPECT_EQ( parsed.getLatestValue( ParseEventsEnum::eLongA ), "default-a" );
+
+  // Only the defaults of options left out.
+  const char* withLongA[3]{ { "exe" }, { "--long-option-a" }, { "v" } };
+  EXPECT_EQ( parseEvents( options, withLongA ), ( std::vector<std::string>{ "option 2 long-option-a 1", "value 2 v" } ) );
+}
+
+
+void testParseEventsEnvironment()
+{
+  const auto options{ makeOptions( true ) };
+  const char* argv[1]{ { "exe" } };
+
+  setenv( "LB_OPTIONS_TEST_EVENTS", " p  q ", 1 );
+  EXPECT_EQ( parseEvents( options, argv )
+           , ( std::vector<std::string>{ "option 4 LB_OPTIONS_TEST_EVENTS 0", "value 4 p", "value 4 q", "default 2 1" } ) );
+
+  // The command line wins.
+  const char* bound[2]{ { "exe" }, { "--bound" } };
+  EXPECT_EQ( parseEvents( options, bound ), ( std::vector<std::string>{ "option 4 bound 1", "default 2 1" } ) );
+
+  setenv( "LB_OPTIONS_TEST_EVENTS", "p q r", 1 );
+  RecordingHandler handler;
+  EXPECT_THROW( options.parse( 1, const_cast<char**>( argv ), handler ), std::runtime_error );
+  unsetenv( "LB_OPTIONS_TEST_EVENTS" );
+}
+
+
+// Each error matches the one parse throws.
+void testParseEventsErrors()
+{
+  const auto strict{ makeOptions( false ) };
+  const auto relaxed{ makeOptions( true ) };
+
+  const char* unknownShort[2]{ { "exe" }, { "-ax" } };
+  const char* unknownLong[2]{ { "exe" }, { "--long-option-c" } };
+  const char* tooFew[4]{ { "exe" }, { "--long-option-b" }, { "x" }, { "-a" } };
+  const char* tooMany[5]{ { "exe" }, { "--long-option-a" }, { "1" }, { "2" }, { "-a" } };
+  const char* trailing[4]{ { "exe" }, { "--long-option-a" }, { "1" }, { "2" } };
+  const std::vector< std::pair<int, char**> > lines
+  {
+    { 2, const_cast<char**>( unknownShort ) },
+    { 2, const_cast<char**>( unknownLong ) },
+    { 4, const_cast<char**>( tooFew ) },
+    { 5, const_cast<char**>( tooMany ) },
+    { 4, const_cast<char**>( trailing ) },
+    { 0, const_cast<char**>( trailing ) },
+  };
+
+  for ( const auto* options : { &strict, &relaxed } )
+  {
+    for ( const auto& [argc, argv] : lines )
+    {
+      const auto error{ options->tryParse( argc, argv ).getError() };
+      RecordingHandler handler;
+      try
+      {
+        options->parse( argc, argv, handler );
+        EXPECT_FALSE( error ) << describe( error );
+      }
+      catch ( const std::runtime_error& e )
+      {
+        EXPECT_EQ( describe( error ), e.what() );
+      }
+    }
+  }
+
+  // Arguments that would need a response file or subcommand are not taken
+  // as trailing values.
+  lb::options::Options<ParseEventsEnum>::Configuration config;
+  config.allowTrailingValues = true;
+  config.expandResponseFiles = true;
+  const lb::options::Options<ParseEventsEnum> expanding{ { { ParseEventsEnum::eShortA, 'a', {}, 0, 0, "A flag." } }, config };
+  auto withSubcommand{ makeOptions( true ) };
+  withSubcommand.addSubcommand( "sub", []{ return makeOptions( true ); } );
+  const char* argv[3]{ { "exe" }, { "@file" }, { "sub" } };
+  for ( const auto* options : { &expanding, &std::as_const( withSubcommand ) } )
+  {
+    RecordingHandler handler;
+    EXPECT_THROW( options->parse( 3, const_cast<char**>( argv ), handler ), std::runtime_error );
+    EXPECT_TRUE( handler.events.empty() );
+  }
+
+  // A handler needs every member.
+  struct NoDefaults
+  {
+    void onOption( ParseEventsEnum, std::string_view, std::size_t ) {}
+    void onValue( ParseEventsEnum, std::string_view ) {}
+    void onTrailing( std::string_view ) {}
+  };
+  static_assert( lb::options::isParseHandler<RecordingHandler, ParseEventsEnum> );
+  static_assert( !lb::options::isParseHandler<NoDefaults, ParseEventsEnum> );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ParseEvents)
+{
+  testParseEvents();
+  testParseEventsEnvironment();
+  testParseEventsErrors();
+}
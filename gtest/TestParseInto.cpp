@@ -0,0 +1,235 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <lb/options/Options.h>
+
+
+// Count every allocation made by this binary so that we can show parseInto
+// makes none once warmed up. Atomic as other tests allocate from several
+// threads.
+namespace
+{
+std::atomic<std::size_t> numAllocations{ 0 };
+}
+
+void* operator new( std::size_t size )
+{
+  numAllocations.fetch_add( 1, std::memory_order_relaxed );
+  if ( void* const p{ std::malloc( size ? size : 1 ) } )
+  {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete( void* p ) noexcept
+{
+  std::free( p );
+}
+
+void operator delete( void* p, std::size_t ) noexcept
+{
+  std::free( p );
+}
+
+
+namespace
+{
+
+
+enum class ParseIntoEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+const lb::options::Options<ParseIntoEnum>& getOptions()
+{
+  static const lb::options::Options<ParseIntoEnum> options
+  {
+    { ParseIntoEnum::eShortA, 'a' , {}             , 0, 0, "A short option that requires no arguments." },
+    { ParseIntoEnum::eShortB, 'b' , {}             , 1, 3, "A short option that requires one to three arguments." },
+    { ParseIntoEnum::eLongA , '\0', "long-option-a", 1, 1, "A long option with a long default.", { "a default value long enough to need an allocation" } },
+    { ParseIntoEnum::eLongB , '\0', "long-option-b", 1, 1, "A long option that requires a single argument." },
+  };
+  return options;
+}
+
+
+bool isSameResult( const lb::options::ParsedOptions<ParseIntoEnum>& lhs
+                 , const lb::options::ParsedOptions<ParseIntoEnum>& rhs )
+{
+  if ( ( lhs.executable != rhs.executable )
+    || ( lhs.trailingValues != rhs.trailingValues )
+    || ( lhs.optionsByKey.size() != rhs.optionsByKey.size() )
+    || ( lhs.optionsByArgvPosition.size() != rhs.optionsByArgvPosition.size() ) )
+  {
+    return false;
+  }
+  for ( const auto& [key, option] : lhs.optionsByKey )
+  {
+    const auto I{ rhs.optionsByKey.find( key ) };
+    if ( ( I == rhs.optionsByKey.end() )
+      || ( I->second.occurrences.size() != option.occurrences.size() ) )
+    {
+      return false;
+    }
+    for ( std::size_t i = 0; i < option.occurrences.size(); ++i )
+    {
+      if ( I->second.occurrences[i].values != option.occurrences[i].values )
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+void testParseIntoReplaces()
+{
+  const auto& options{ getOptions() };
+
+  const char* argv1[5]{ { "exe1" }, { "-a" }, { "--long-option-a" }, { "aaa" }, { "trailing" } };
+  const char* argv2[4]{ { "exe2" }, { "-b" }, { "bbb" }, { "bbb2" } };
+
+  lb::options::ParsedOptions<ParseIntoEnum> parsed;
+  options.parseInto( parsed, 5, const_cast<char**>( argv1 ) );
+  EXPECT_EQ( parsed.executable, argv1[0] );
+  EXPECT_TRUE( parsed.isPresent( ParseIntoEnum::eShortA ) );
+  EXPECT_EQ( parsed.getLatestValue( ParseIntoEnum::eLongA ), argv1[3] );
+  ASSERT_EQ( parsed.trailingValues.size(), 1 );
+
+  // Nothing of the first parse may show through in the second.
+  options.parseInto( parsed, 4, const_cast<char**>( argv2 ) );
+  EXPECT_TRUE( isSameResult( parsed, options.parse( 4, const_cast<char**>( argv2 ) ) ) );
+  EXPECT_EQ( parsed.executable, argv2[0] );
+  EXPECT_FALSE( parsed.isPresent( ParseIntoEnum::eShortA ) );
+  EXPECT_FALSE( parsed.isPresent( ParseIntoEnum::eLongB ) );
+  EXPECT_EQ( parsed.getLatestValue( ParseIntoEnum::eLongA ), options.getDefinition( ParseIntoEnum::eLongA ).defaultValues.front() );
+  ASSERT_EQ( parsed.optionsByKey.at( ParseIntoEnum::eShortB ).occurrences.size(), 1 );
+  ASSERT_EQ( parsed.optionsByKey.at( ParseIntoEnum::eShortB ).occurrences.front().values.size(), 2 );
+  ASSERT_EQ( parsed.optionsByArgvPosition.size(), 1 );
+  EXPECT_TRUE( parsed.trailingValues.empty() );
+
+  // A copy is independent of the original's spare storage.
+  const auto copy{ parsed };
+  options.parseInto( parsed, 5, const_cast<char**>( argv1 ) );
+  EXPECT_EQ( copy.getLatestValue( ParseIntoEnum::eShortB ), argv2[3] );
+}
+
+
+void testParseIntoDoesNotAllocate()
+{
+  const auto& options{ getOptions() };
+
+  const char* argv1[10]
+  {
+    { "an executable name long enough to need an allocation" },
+    { "-ab" }, { "a value long enough to need an allocation" }, { "bbb" },
+    { "--long-option-b" }, { "another value long enough to need an allocation" },
+    { "-b" }, { "bbb2" },
+    { "trailing value long enough to need an allocation" },
+    { "short" },
+  };
+
+  // Same shape, different order and values.
+  const char* argv2[10]
+  {
+    { "another executable name long enough to need an allocation" },
+    { "--long-option-b" }, { "a different value long enough to need an allocation" },
+    { "-b" }, { "b" },
+    { "-ab" }, { "yet another value long enough to need an allocation" }, { "bb" },
+    { "a trailing value long enough to need an allocation" },
+    { "s" },
+  };
+
+  lb::options::ParsedOptions<ParseIntoEnum> parsed;
+
+  // Let the storage grow to fit both.
+  for ( int i = 0; i < 4; ++i )
+  {
+    options.parseInto( parsed, 10, const_cast<char**>( argv1 ) );
+    options.parseInto( parsed, 10, const_cast<char**>( argv2 ) );
+  }
+
+  const auto before{ numAllocations.load() };
+  options.parseInto( parsed, 10, const_cast<char**>( argv1 ) );
+  options.parseInto( parsed, 10, const_cast<char**>( argv2 ) );
+  const auto after{ numAllocations.load() };
+  EXPECT_EQ( after - before, 0 );
+
+  // Whereas a fresh result has to allocate (which also shows we are counting).
+  const auto fresh{ options.parse( 10, const_cast<char**>( argv2 ) ) };
+  EXPECT_GT( numAllocations - after, 0 );
+
+  EXPECT_TRUE( isSameResult( parsed, fresh ) );
+}
+
+
+void testTryParseIntoRejectsWithoutAllocating()
+{
+  const auto& options{ getOptions() };
+
+  const char* good[4]{ { "exe" }, { "-b" }, { "a value long enough to need an allocation" }, { "-a" } };
+  const char* unknown[4]{ { "exe" }, { "-b" }, { "a value long enough to need an allocation" }, { "--no-such-option" } };
+  const char* tooFew[3]{ { "exe" }, { "--long-option-b" }, { "-a" } };
+
+  lb::options::ParsedOptions<ParseIntoEnum> parsed;
+  for ( int i = 0; i < 2; ++i )
+  {
+    EXPECT_FALSE( options.tryParseInto( parsed, 4, const_cast<char**>( good ) ) );
+  }
+
+  const auto before{ numAllocations.load() };
+  const auto unknownError{ options.tryParseInto( parsed, 4, const_cast<char**>( unknown ) ) };
+  const auto tooFewError{ options.tryParseInto( parsed, 3, const_cast<char**>( tooFew ) ) };
+  EXPECT_EQ( numAllocations.load() - before, 0 );
+
+  EXPECT_EQ( unknownError.code, lb::options::ParseErrorCode::eUnknownLongOption );
+  EXPECT_EQ( tooFewError.code, lb::options::ParseErrorCode::eTooFewValues );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ParseInto)
+{
+  testParseIntoReplaces();
+  testParseIntoDoesNotAllocate();
+  testTryParseIntoRejectsWithoutAllocating();
+}
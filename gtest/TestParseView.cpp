@@ -0,0 +1,178 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class ViewEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+void testParseViewValues()
+{
+  const lb::options::Options<ViewEnum> options
+  {
+    { ViewEnum::eShortA, 'a' , {}             , 0, 0, "A short option that requires no arguments." },
+    { ViewEnum::eShortB, 'b' , {}             , 1, 2, "A short option that requires one or two arguments." },
+    { ViewEnum::eLongA , '\0', "long-option-a", 1, 1, "A long option that requires a single argument with a default.", { "bob" } },
+    { ViewEnum::eLongB , '\0', "long-option-b", 1, 1, "A long option that requires a single argument." },
+  };
+
+  const char* argv[9]
+  {
+    { "exe" },
+    { "-ab" }, { "bbb" }, { "" },
+    { "-b" }, { "bbb2" },
+    { "--long-option-b" }, { "sue" },
+    { "foo" }
+  };
+
+  lb::options::ParsedOptionsView<ViewEnum> parsed;
+  ASSERT_NO_THROW( parsed = options.parseView( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ) );
+
+  // Everything must refer straight back into argv, nothing copied.
+  EXPECT_EQ( parsed.executable.data(), argv[0] );
+  EXPECT_TRUE( parsed.isPresent( ViewEnum::eShortA ) );
+
+  const auto& occurrencesB{ parsed.optionsByKey.at( ViewEnum::eShortB ).occurrences };
+  ASSERT_EQ( occurrencesB.size(), 2 );
+  ASSERT_EQ( occurrencesB[0].values.size(), 2 );
+  EXPECT_EQ( occurrencesB[0].values[0].data(), argv[2] );
+  EXPECT_EQ( occurrencesB[0].values[1].data(), argv[3] );
+  EXPECT_TRUE( occurrencesB[0].values[1].empty() );
+  ASSERT_EQ( occurrencesB[1].values.size(), 1 );
+  EXPECT_EQ( occurrencesB[1].values[0].data(), argv[5] );
+
+  EXPECT_EQ( parsed.getLatestValue( ViewEnum::eLongB ).data(), argv[7] );
+  EXPECT_EQ( parsed.getLatestValue( ViewEnum::eShortB ), "bbb2" );
+
+  ASSERT_EQ( parsed.trailingValues.size(), 1 );
+  EXPECT_EQ( parsed.trailingValues.front().data(), argv[8] );
+
+  // Defaults refer into the Options instance.
+  EXPECT_EQ( parsed.getLatestValue( ViewEnum::eLongA ).data()
+           , options.getDefinition( ViewEnum::eLongA ).defaultValues.front().data() );
+
+  ASSERT_EQ( parsed.optionsByArgvPosition.size(), 4 );
+  EXPECT_EQ( parsed.optionsByArgvPosition[0].positionIndex, 1 );
+  EXPECT_EQ( parsed.optionsByArgvPosition[1].positionIndex, 1 );
+  EXPECT_EQ( parsed.optionsByArgvPosition[2].positionIndex, 4 );
+  EXPECT_EQ( parsed.optionsByArgvPosition[3].positionIndex, 6 );
+}
+
+void testParseViewMatchesParse()
+{
+  const lb::options::Options<ViewEnum> options
+  {
+    { ViewEnum::eShortA, 'a' , {}             , 0, 0, "A short option that requires no arguments." },
+    { ViewEnum::eShortB, 'b' , {}             , 1, 1, "A short option that requires a single argument." },
+    { ViewEnum::eLongA , '\0', "long-option-a", 2, 2, "A long option that requires two arguments with defaults.", { "x", "y" } },
+  };
+
+  const char* argv[5]
+  {
+    { "exe" },
+    { "-b" }, { "bbb" },
+    { "-a" },
+    { "trailing" },
+  };
+
+  const auto parsed{ options.parse( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ) };
+  const auto view  { options.parseView( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ) };
+
+  EXPECT_EQ( parsed.executable, view.executable );
+  ASSERT_EQ( parsed.optionsByKey.size(), view.optionsByKey.size() );
+  for ( const auto& [ key, option ] : parsed.optionsByKey )
+  {
+    const auto V{ view.optionsByKey.find( key ) };
+    ASSERT_NE( V, view.optionsByKey.end() );
+    ASSERT_EQ( option.occurrences.size(), V->second.occurrences.size() );
+    for ( size_t i = 0; i < option.occurrences.size(); ++i )
+    {
+      const auto& values{ option.occurrences[i].values };
+      const auto& viewValues{ V->second.occurrences[i].values };
+      ASSERT_EQ( values.size(), viewValues.size() );
+      for ( size_t j = 0; j < values.size(); ++j )
+      {
+        EXPECT_EQ( values[j], viewValues[j] );
+      }
+    }
+  }
+  ASSERT_EQ( parsed.trailingValues.size(), view.trailingValues.size() );
+  EXPECT_EQ( parsed.trailingValues.front(), view.trailingValues.front() );
+}
+
+void testParseViewErrors()
+{
+  const lb::options::Options<ViewEnum> options
+  {
+    { ViewEnum::eShortB, 'b' , {}             , 1, 1, "A short option that requires a single argument." },
+    { ViewEnum::eLongA , '\0', "long-option-a", 0, 0, "A long option that requires no arguments." },
+  };
+
+  const char* argv1[2]{ { "exe" }, { "--nope" } };
+  EXPECT_THROW( options.parseView( sizeof(argv1)/sizeof(argv1[0]), const_cast<char**>( argv1 ) ), std::runtime_error );
+
+  const char* argv2[3]{ { "exe" }, { "-b" }, { "--long-option-a" } };
+  EXPECT_THROW( options.parseView( sizeof(argv2)/sizeof(argv2[0]), const_cast<char**>( argv2 ) ), std::runtime_error );
+}
+
+
+// As when the results were aggregates, one can be started from argv[0].
+void testParsedOptionsFromExecutable()
+{
+  const char* argv[1]{ { "exe" } };
+  const lb::options::ParsedOptions<ViewEnum> parsed{ argv[0] };
+  const lb::options::ParsedOptionsView<ViewEnum> view{ argv[0] };
+  EXPECT_EQ( parsed.executable, "exe" );
+  EXPECT_EQ( view.executable.data(), argv[0] );
+  EXPECT_TRUE( parsed.optionsByKey.empty() );
+  EXPECT_FALSE( parsed.isPresent( ViewEnum::eShortA ) );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ParseView)
+{
+  testParseViewValues();
+  testParseViewMatchesParse();
+  testParseViewErrors();
+  testParsedOptionsFromExecutable();
+}
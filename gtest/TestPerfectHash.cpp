@@ -0,0 +1,150 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <lb/options/Options.h>
+#include <lb/options/PerfectHash.h>
+
+
+namespace
+{
+
+
+enum class HashEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+  eLongC,
+  eMissing,
+};
+
+// A deliberately terrible hash so that keys collide.
+struct ConstantHash
+{
+  std::size_t operator()( HashEnum ) const { return 42; }
+};
+
+
+void testMinimalPerfectHash()
+{
+  for ( std::size_t n : { 0, 1, 2, 3, 17, 1000, 10000 } )
+  {
+    std::vector<std::uint64_t> hashes;
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+      hashes.push_back( lb::options::hashString( "option-" + std::to_string( i ) ) );
+    }
+
+    lb::options::MinimalPerfectHash mph;
+    ASSERT_TRUE( mph.build( hashes ) ) << n;
+    EXPECT_EQ( mph.empty(), n == 0 );
+
+    // Every hash finds itself so, being minimal, the indices are a permutation.
+    std::set<lb::options::MinimalPerfectHash::Index> seen;
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+      ASSERT_EQ( mph.find( hashes[i] ), i ) << n;
+      seen.insert( mph.find( hashes[i] ) );
+    }
+    EXPECT_EQ( seen.size(), n );
+  }
+
+  const std::vector<std::uint64_t> duplicated{ 1, 2, 3, 2 };
+  lb::options::MinimalPerfectHash mph;
+  EXPECT_FALSE( mph.build( duplicated ) );
+  EXPECT_TRUE( mph.empty() );
+  EXPECT_EQ( mph.find( 1 ), lb::options::MinimalPerfectHash::None );
+
+  const std::vector<std::uint64_t> hashes{ 10, 20, 30 };
+  ASSERT_TRUE( mph.build( hashes, { 7, 8, 9 } ) );
+  EXPECT_EQ( mph.find( 10 ), 7 );
+  EXPECT_EQ( mph.find( 20 ), 8 );
+  EXPECT_EQ( mph.find( 30 ), 9 );
+}
+
+template< class Hash >
+void testPerfectHashOptions( const std::string& context )
+{
+  using Options = lb::options::Options<HashEnum, Hash>;
+  const Options options
+  {
+    {
+      { HashEnum::eShortA, 'a' , {}             , 0, 0, "A short option that requires no arguments." },
+      { HashEnum::eShortB, 'b' , {}             , 1, 1, "A short option that requires a single argument." },
+      { HashEnum::eLongA , '\0', "long-option-a", 0, 0, "A long option that requires no arguments." },
+      { HashEnum::eLongB , '\0', "long-option-b", 1, 1, "A long option that requires a single argument with a default.", { "bob" } },
+      { HashEnum::eLongC , 'c' , "long-option-c", 1, 2, "A short/long option that requires one or two arguments." },
+    },
+    { true, true, true }
+  };
+
+  EXPECT_EQ( options.getDefinition( HashEnum::eShortB ).s, 'b' ) << context;
+  EXPECT_EQ( options.getDefinition( HashEnum::eLongC ).l, "long-option-c" ) << context;
+  EXPECT_THROW( options.getDefinition( HashEnum::eMissing ), std::runtime_error ) << context;
+
+  EXPECT_EQ( options.findLong( "long-option-a" )->key, HashEnum::eLongA ) << context;
+  EXPECT_EQ( options.findLong( "long-option-c" )->key, HashEnum::eLongC ) << context;
+  EXPECT_EQ( options.findLong( "long-option-d" ), nullptr ) << context;
+  EXPECT_EQ( options.findLong( "long-option-" ), nullptr ) << context;
+  // Abbreviations still resolve through the trie.
+  EXPECT_EQ( options.findLong( "long-option-b" )->key, HashEnum::eLongB ) << context;
+
+  const char* argv[7]
+  {
+    { "exe" },
+    { "-ab" }, { "bbb" },
+    { "--long-option-a" },
+    { "--long-option-c" }, { "x" }, { "y" },
+  };
+
+  lb::options::ParsedOptions<HashEnum, Hash> parsed;
+  ASSERT_NO_THROW( parsed = options.parse( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ) ) ) << context;
+  EXPECT_TRUE( parsed.isPresent( HashEnum::eShortA ) ) << context;
+  EXPECT_EQ( parsed.getLatestValue( HashEnum::eShortB ), "bbb" ) << context;
+  EXPECT_TRUE( parsed.isPresent( HashEnum::eLongA ) ) << context;
+  EXPECT_EQ( parsed.getLatestValue( HashEnum::eLongB ), "bob" ) << context;
+  EXPECT_EQ( parsed.getLatestValue( HashEnum::eLongC ), "y" ) << context;
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, PerfectHash)
+{
+  testMinimalPerfectHash();
+  testPerfectHashOptions<std::hash<HashEnum>>( "std::hash" );
+  // Keys that cannot be perfectly hashed fall back on a map.
+  testPerfectHashOptions<ConstantHash>( "ConstantHash" );
+}
@@ -0,0 +1,154 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class PmrEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+// Any allocation not from the resource we hand over goes to the default
+// resource, make that fail loudly for the duration.
+struct NoDefaultResource
+{
+  NoDefaultResource() : previous{ std::pmr::set_default_resource( std::pmr::null_memory_resource() ) } {}
+  ~NoDefaultResource() { std::pmr::set_default_resource( previous ); }
+
+  std::pmr::memory_resource* previous;
+};
+
+
+void testPmrParse()
+{
+  const lb::options::Options<PmrEnum> options
+  {
+    { PmrEnum::eShortA, 'a' , {}             , 0, 0, "A short option that requires no arguments." },
+    { PmrEnum::eShortB, 'b' , {}             , 1, 3, "A short option that requires one to three arguments." },
+    { PmrEnum::eLongA , '\0', "long-option-a", 1, 1, "A long option with a long default.", { "a default value long enough to need an allocation" } },
+    { PmrEnum::eLongB , '\0', "long-option-b", 1, 1, "A long option that requires a single argument." },
+  };
+
+  const char* argv[10]
+  {
+    { "an executable name long enough to need an allocation" },
+    { "-ab" }, { "a value long enough to need an allocation" }, { "bbb" },
+    { "--long-option-b" }, { "another value long enough to need an allocation" },
+    { "-b" }, { "bbb2" },
+    { "trailing value long enough to need an allocation" },
+    { "short" },
+  };
+
+  std::array<std::byte, 16384> buffer;
+  std::pmr::monotonic_buffer_resource arena{ buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+
+  {
+    const NoDefaultResource noDefault;
+
+    const auto parsed{ options.parse( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ), &arena ) };
+
+    EXPECT_EQ( parsed.executable, argv[0] );
+    EXPECT_TRUE( parsed.isPresent( PmrEnum::eShortA ) );
+
+    const auto& occurrencesB{ parsed.optionsByKey.at( PmrEnum::eShortB ).occurrences };
+    ASSERT_EQ( occurrencesB.size(), 2 );
+    ASSERT_EQ( occurrencesB[0].values.size(), 2 );
+    EXPECT_EQ( occurrencesB[0].values[0], argv[2] );
+    EXPECT_EQ( occurrencesB[0].values[1], argv[3] );
+    ASSERT_EQ( occurrencesB[1].values.size(), 3 );
+    EXPECT_EQ( occurrencesB[1].values[1], argv[8] );
+
+    const auto& valuesLongA{ parsed.optionsByKey.at( PmrEnum::eLongA ).occurrences.back().values };
+    ASSERT_EQ( valuesLongA.size(), 1 );
+    EXPECT_EQ( std::string_view{ valuesLongA.front() }, options.getDefinition( PmrEnum::eLongA ).defaultValues.front() );
+
+    // Everything, right down to the values, uses the arena.
+    EXPECT_EQ( parsed.executable.get_allocator().resource(), &arena );
+    EXPECT_EQ( parsed.optionsByKey.get_allocator().resource(), &arena );
+    EXPECT_EQ( occurrencesB.get_allocator().resource(), &arena );
+    EXPECT_EQ( occurrencesB[0].values.get_allocator().resource(), &arena );
+    EXPECT_EQ( occurrencesB[0].values[0].get_allocator().resource(), &arena );
+    EXPECT_EQ( valuesLongA.front().get_allocator().resource(), &arena );
+    EXPECT_EQ( parsed.optionsByArgvPosition.get_allocator().resource(), &arena );
+    ASSERT_TRUE( parsed.trailingValues.empty() );
+  }
+
+  // Errors still throw, whatever has been allocated goes with the arena.
+  const char* badArgv[3]{ { "exe" }, { "--long-option-b" }, { "-a" } };
+  EXPECT_THROW( options.parse( 3, const_cast<char**>( badArgv ), &arena ), std::runtime_error );
+
+  arena.release();
+}
+
+void testPmrTrailing()
+{
+  const lb::options::Options<PmrEnum> options
+  {
+    { PmrEnum::eShortA, 'a', {}, 0, 0, "A short option that requires no arguments." },
+  };
+
+  const char* argv[4]
+  {
+    { "exe" },
+    { "-a" },
+    { "a trailing value long enough to need an allocation" },
+    { "another trailing value long enough to need an allocation" },
+  };
+
+  std::pmr::monotonic_buffer_resource arena{ 4096 };
+  const NoDefaultResource noDefault;
+  const auto parsed{ options.parse( sizeof(argv)/sizeof(argv[0]), const_cast<char**>( argv ), &arena ) };
+  ASSERT_EQ( parsed.trailingValues.size(), 2 );
+  EXPECT_EQ( parsed.trailingValues[1], argv[3] );
+  EXPECT_EQ( parsed.trailingValues[1].get_allocator().resource(), &arena );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, Pmr)
+{
+  testPmrParse();
+  testPmrTrailing();
+}
@@ -27,10 +27,13 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <sstream>
 
 #include <lb/options/print.h>
 #include <lb/options/OptionDefinition.h>
+#include <lb/options/Options.h>
+#include <lb/options/Usage.h>
 
 
 void testPrintOptions1()
@@ -194,7 +197,75 @@ void testPrintOptions1()
 }
 
 
+void testAppendWrapped()
+{
+  std::string out{ "kept" };
+  lb::options::appendWrapped( out, "one two three\nfour fivesixseven", "  ", true, 9 );
+  EXPECT_EQ( out, "keptone two\n  three\n\n  four\n  fivesixse\n  ven\n" );
+
+  // No width at all is one character a line.
+  out.clear();
+  lb::options::appendWrapped( out, "ab c", "", false, 0 );
+  EXPECT_EQ( out, "a\nb\n\nc\n" );
+  out.clear();
+  lb::options::appendOption( out, { 'a', "all", 0, 0, "Do it.", { "x" } }, 4, 0 );
+  EXPECT_EQ( out.rfind( "    -a, --all\n        D\n        o\n", 0 ), 0 ) << out;
+}
+
+
+enum class PrintEnum
+{
+  eA,
+  eB,
+  eC,
+};
+
+
+void testPrintUsage()
+{
+  const lb::options::Options<PrintEnum> options
+  {
+    { PrintEnum::eA, 'a' , "aaa", 0, 0, "A short/long option expecting no arguments and with no default values." },
+    { PrintEnum::eB, '\0', "bbb", 1, 1, "A long option with a default.", { "default-b" } },
+    { PrintEnum::eC, 'c' , {}   , 0, 0, "A short option with a short description." },
+  };
+
+  // At 72 columns the same as printing each with the default width.
+  std::ostringstream each;
+  for ( std::size_t slot = 0; slot < options.size(); ++slot )
+  {
+    lb::options::print( each, options.definitionAt( slot ).option, 4 );
+  }
+  std::ostringstream all;
+  lb::options::printUsage( all, options, 72 );
+  EXPECT_EQ( all.str(), each.str() );
+
+  // Narrower.
+  std::ostringstream narrow;
+  lb::options::printUsage( narrow, options, 40 );
+  EXPECT_EQ( narrow.str().substr( 0, 109 ), "    -a, --aaa\n"
+                                            "        A short/long option expecting\n"
+                                            "        no arguments and with no\n"
+                                            "        default values.\n" );
+
+  // Rendered once per width.
+  lb::options::UsageCache<PrintEnum> cache{ options };
+  const auto& usage{ cache.get( 72 ) };
+  EXPECT_EQ( usage, all.str() );
+  EXPECT_EQ( &cache.get( 72 ), &usage );
+  EXPECT_EQ( cache.get( 40 ), narrow.str() );
+
+  // Not a terminal so from COLUMNS.
+  setenv( "COLUMNS", "100", 1 );
+  EXPECT_EQ( lb::options::terminalWidth( -1 ), 100 );
+  unsetenv( "COLUMNS" );
+  EXPECT_EQ( lb::options::terminalWidth( -1 ), 80 );
+}
+
+
 TEST(Options, Print)
 {
   testPrintOptions1();
+  testAppendWrapped();
+  testPrintUsage();
 }
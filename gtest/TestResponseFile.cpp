@@ -0,0 +1,264 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <lb/options/Options.h>
+#include <lb/options/ResponseFile.h>
+
+
+namespace
+{
+
+
+enum class ResponseEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+// A response file that deletes itself.
+struct TemporaryFile
+{
+  explicit TemporaryFile( const std::string& contents )
+  {
+    char name[]{ "/tmp/lbOptionsResponseXXXXXX" };
+    const int fd{ ::mkstemp( name ) };
+    ::close( fd );
+    path = name;
+    std::ofstream{ path } << contents;
+  }
+  ~TemporaryFile() { std::remove( path.c_str() ); }
+
+  std::string argument() const { return "@" + path; }
+
+  std::string path;
+};
+
+
+std::vector<std::string> tokenize( std::string contents )
+{
+  lb::options::ResponseFileTokenizer tokenizer{ contents.data(), contents.data() + contents.size() };
+  std::vector<std::string> tokens;
+  std::string_view token;
+  while ( tokenizer.next( token ) )
+  {
+    tokens.emplace_back( token );
+  }
+  return tokens;
+}
+
+
+void testTokenizer()
+{
+  EXPECT_EQ( tokenize( "" ), std::vector<std::string>{} );
+  EXPECT_EQ( tokenize( " \n\t " ), std::vector<std::string>{} );
+  EXPECT_EQ( tokenize( "-a  --long-option-a\nvalue\r\n" )
+           , ( std::vector<std::string>{ "-a", "--long-option-a", "value" } ) );
+  EXPECT_EQ( tokenize( R"('single quoted' "double quoted" mixed' 'and" "plain)" )
+           , ( std::vector<std::string>{ "single quoted", "double quoted", "mixed and plain" } ) );
+  EXPECT_EQ( tokenize( R"("" '' "a \"b\" \\ \c" 'no \escape' back\ slash\')" )
+           , ( std::vector<std::string>{ "", "", R"(a "b" \ \c)", R"(no \escape)", "back slash'" } ) );
+
+  EXPECT_THROW( tokenize( "'open" ), std::runtime_error );
+  EXPECT_THROW( tokenize( "\"open" ), std::runtime_error );
+  EXPECT_THROW( tokenize( "trailing\\" ), std::runtime_error );
+}
+
+
+// Without quotes or escapes the buffer is only read, here from a read only
+// page that any write would fault on.
+void testTokenizerLeavesPlainTextAlone()
+{
+  const std::string_view Text{ "-a --long-option-a value\n-b one two" };
+  const long PageSize{ ::sysconf( _SC_PAGESIZE ) };
+  void* const page{ ::mmap( nullptr, PageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) };
+  ASSERT_NE( page, MAP_FAILED );
+  char* const begin{ static_cast<char*>( page ) };
+  Text.copy( begin, Text.size() );
+  ASSERT_EQ( ::mprotect( page, PageSize, PROT_READ ), 0 );
+
+  lb::options::ResponseFileTokenizer tokenizer{ begin, begin + Text.size() };
+  std::vector<std::string> tokens;
+  std::string_view token;
+  while ( tokenizer.next( token ) )
+  {
+    tokens.emplace_back( token );
+  }
+  EXPECT_EQ( tokens, ( std::vector<std::string>{ "-a", "--long-option-a", "value", "-b", "one", "two" } ) );
+  ::munmap( page, PageSize );
+}
+
+
+void testParseResponseFile()
+{
+  lb::options::Options<ResponseEnum>::Configuration config;
+  config.expandResponseFiles = true;
+  const lb::options::Options<ResponseEnum> options
+  {
+    {
+      { ResponseEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+      { ResponseEnum::eShortB, 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+      { ResponseEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option that requires a single argument." },
+      { ResponseEnum::eLongB , '\0', "long-option-b", 1,  1, "A long option that requires a single argument." },
+    }
+  , config };
+
+  auto nested{ std::make_unique<TemporaryFile>( "--long-option-b 'from the nested file'" ) };
+  auto outer{ std::make_unique<TemporaryFile>( "-a --long-option-a \"quoted value\" " + nested->argument() + "\n-b" ) };
+  const std::string outerArgument{ outer->argument() };
+
+  const char* argv[5]{ { "exe" }, { "--long-option-a" }, { "first" }, { outerArgument.c_str() }, { "b1" } };
+  auto parsed{ std::make_unique<lb::options::ParsedOptionsView<ResponseEnum>>(
+                 options.parseView( 5, const_cast<char**>( argv ) ) ) };
+
+  ASSERT_EQ( parsed->optionsByKey.at( ResponseEnum::eLongA ).occurrences.size(), 2 );
+  EXPECT_EQ( parsed->getLatestValue( ResponseEnum::eLongA ), "quoted value" );
+  EXPECT_EQ( parsed->getLatestValue( ResponseEnum::eLongB ), "from the nested file" );
+  EXPECT_EQ( parsed->getLatestValue( ResponseEnum::eShortB ), "b1" );
+  EXPECT_TRUE( parsed->isPresent( ResponseEnum::eShortA ) );
+  EXPECT_EQ( parsed->mappedFiles.size(), 2 );
+
+  // Positions count the expanded arguments.
+  ASSERT_EQ( parsed->optionsByArgvPosition.size(), 5 );
+  EXPECT_EQ( parsed->optionsByArgvPosition[0].positionIndex, 1 );
+  EXPECT_EQ( parsed->optionsByArgvPosition[1].positionIndex, 3 );
+  EXPECT_EQ( parsed->optionsByArgvPosition[2].positionIndex, 4 );
+  EXPECT_EQ( parsed->optionsByArgvPosition[3].positionIndex, 6 );
+  EXPECT_EQ( parsed->optionsByArgvPosition[4].positionIndex, 8 );
+
+  // The views stay valid with the files gone and only a copy left.
+  nested.reset();
+  outer.reset();
+  const auto copy{ *parsed };
+  parsed.reset();
+  EXPECT_EQ( copy.getLatestValue( ResponseEnum::eLongA ), "quoted value" );
+  EXPECT_EQ( copy.getLatestValue( ResponseEnum::eLongB ), "from the nested file" );
+
+  // An owning result needs no mapping.
+  const TemporaryFile file{ "--long-option-b owned" };
+  const std::string fileArgument{ file.argument() };
+  const char* argv2[2]{ { "exe" }, { fileArgument.c_str() } };
+  const auto owned{ options.parse( 2, const_cast<char**>( argv2 ) ) };
+  EXPECT_EQ( owned.getLatestValue( ResponseEnum::eLongB ), "owned" );
+  EXPECT_TRUE( owned.mappedFiles.empty() );
+
+  // An option left short of values in a file, whose mapping an owning parse
+  // has already let go of, is still reported by its flag.
+  const TemporaryFile shortOfValues{ "--long-option-a" };
+  const std::string shortArgument{ shortOfValues.argument() };
+  const char* argv6[3]{ { "exe" }, { shortArgument.c_str() }, { "-a" } };
+  try
+  {
+    options.parse( 3, const_cast<char**>( argv6 ) );
+    ADD_FAILURE() << "No exception";
+  }
+  catch ( const std::runtime_error& e )
+  {
+    EXPECT_STREQ( e.what(), "Too few values for option long-option-a" );
+  }
+
+  // As are the errors diagnose records, which an owning result keeps the
+  // file mapped for.
+  {
+    const TemporaryFile badFlag{ "--no-such-option -a" };
+    const std::string badArgument{ badFlag.argument() };
+    const char* argv7[2]{ { "exe" }, { badArgument.c_str() } };
+    lb::options::ParsedOptions<ResponseEnum> diagnosed;
+    lb::options::ParseDiagnostics<ResponseEnum> diagnostics;
+    EXPECT_FALSE( options.diagnose( diagnosed, diagnostics, 2, const_cast<char**>( argv7 ) ) );
+    EXPECT_TRUE( diagnosed.isPresent( ResponseEnum::eShortA ) );
+    EXPECT_EQ( diagnosed.mappedFiles.size(), 1 );
+    EXPECT_EQ( diagnostics.describe(), "argv[1]: Unknown long option no-such-option\n" );
+  }
+
+  // Failures.
+  const char* missing[2]{ { "exe" }, { "@/no/such/response/file" } };
+  EXPECT_THROW( options.parse( 2, const_cast<char**>( missing ) ), std::runtime_error );
+
+  const TemporaryFile malformed{ "-b 'unterminated" };
+  const std::string malformedArgument{ malformed.argument() };
+  const char* argv3[2]{ { "exe" }, { malformedArgument.c_str() } };
+  EXPECT_THROW( options.parse( 2, const_cast<char**>( argv3 ) ), std::runtime_error );
+
+  const TemporaryFile recursive{ "" };
+  std::ofstream{ recursive.path } << recursive.argument();
+  const std::string recursiveArgument{ recursive.argument() };
+  const char* argv4[2]{ { "exe" }, { recursiveArgument.c_str() } };
+  EXPECT_THROW( options.parse( 2, const_cast<char**>( argv4 ) ), std::runtime_error );
+
+  // Many more arguments than would fit on a command line.
+  std::string many{ "-b" };
+  for ( int i = 0; i < 100000; ++i )
+  {
+    many += " value" + std::to_string( i );
+  }
+  const TemporaryFile large{ many };
+  const std::string largeArgument{ large.argument() };
+  const char* argv5[2]{ { "exe" }, { largeArgument.c_str() } };
+  const auto manyParsed{ options.parseView( 2, const_cast<char**>( argv5 ) ) };
+  EXPECT_EQ( manyParsed.optionsByKey.at( ResponseEnum::eShortB ).occurrences.front().values.size(), 100000 );
+  EXPECT_EQ( manyParsed.getLatestValue( ResponseEnum::eShortB ), "value99999" );
+}
+
+
+void testResponseFilesOffByDefault()
+{
+  const lb::options::Options<ResponseEnum> options
+  {
+    { ResponseEnum::eLongA, '\0', "long-option-a", 1, 1, "A long option that requires a single argument." },
+  };
+
+  const char* argv[3]{ { "exe" }, { "--long-option-a" }, { "@someone" } };
+  EXPECT_EQ( options.parse( 3, const_cast<char**>( argv ) ).getLatestValue( ResponseEnum::eLongA ), "@someone" );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, ResponseFile)
+{
+  testTokenizer();
+  testTokenizerLeavesPlainTextAlone();
+  testParseResponseFile();
+  testResponseFilesOffByDefault();
+}
@@ -0,0 +1,225 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <lb/options/MappedFile.h>
+#include <lb/options/Options.h>
+#include <lb/options/Serialize.h>
+
+
+namespace
+{
+
+
+enum class SerializeEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+const lb::options::Options<SerializeEnum>& getOptions()
+{
+  static const lb::options::Options<SerializeEnum> options
+  {
+    { SerializeEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+    { SerializeEnum::eShortB, 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+    { SerializeEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+    { SerializeEnum::eLongB , '\0', "long-option-b", 1,  1, "A long option that requires a single argument." },
+  };
+  return options;
+}
+
+
+lb::options::ParsedOptions<SerializeEnum> parseExample()
+{
+  const char* argv[9]{ { "exe" }, { "-b" }, { "b1" }, { "b2" }, { "-a" }, { "-b" }, { "b3" }
+                     , { "--long-option-b" }, { "" } };
+  return getOptions().parse( 9, const_cast<char**>( argv ) );
+}
+
+
+// A child process picking up the result from a memfd, returning 0 if it
+// matches.
+int checkInChild( int fd )
+{
+  const lb::options::MappedFile file{ fd, lb::options::MappedFile::Mode::eReadOnly };
+  const lb::options::SerializedOptions<SerializeEnum> serialized{ file.data(), file.size() };
+  const bool Matches{ ( serialized.getExecutable() == "exe" )
+                   && serialized.isPresent( SerializeEnum::eShortA )
+                   && ( serialized.getLatestValue( SerializeEnum::eShortB ) == "b3" ) };
+  return Matches ? 0 : 1;
+}
+
+
+void testSerialize()
+{
+  const auto parsed{ parseExample() };
+  const auto blob{ lb::options::serialize( parsed ) };
+
+  const lb::options::SerializedOptions<SerializeEnum> serialized{ blob.data(), blob.size() };
+  EXPECT_EQ( serialized.getExecutable(), "exe" );
+  EXPECT_TRUE( serialized.isPresent( SerializeEnum::eShortA ) );
+  EXPECT_TRUE( serialized.isPresent( SerializeEnum::eLongB ) );
+  EXPECT_EQ( serialized.getLatestValue( SerializeEnum::eShortB ), "b3" );
+  EXPECT_EQ( serialized.getLatestValue( SerializeEnum::eLongA ), "default-a" );
+  EXPECT_EQ( serialized.getLatestValue( SerializeEnum::eLongB ), "" );
+  EXPECT_EQ( serialized.getLatestValue( SerializeEnum::eShortA ), "" );
+
+  // Rebuilt as it was, with the strings still in the blob.
+  lb::options::ParsedOptionsView<SerializeEnum> view;
+  serialized.viewInto( getOptions(), view );
+  EXPECT_EQ( view.executable, parsed.executable );
+  EXPECT_GE( view.executable.data(), blob.data() );
+  EXPECT_LT( view.executable.data(), blob.data() + blob.size() );
+  ASSERT_EQ( view.optionsByKey.size(), parsed.optionsByKey.size() );
+  for ( const auto& [ key, option ] : parsed.optionsByKey )
+  {
+    const auto& occurrences{ view.optionsByKey.at( key ).occurrences };
+    ASSERT_EQ( occurrences.size(), option.occurrences.size() );
+    for ( std::size_t i = 0; i < occurrences.size(); ++i )
+    {
+      EXPECT_EQ( std::vector<std::string>( occurrences[i].values.begin(), occurrences[i].values.end() )
+               , option.occurrences[i].values );
+    }
+  }
+  ASSERT_EQ( view.optionsByArgvPosition.size(), parsed.optionsByArgvPosition.size() );
+  for ( std::size_t i = 0; i < view.optionsByArgvPosition.size(); ++i )
+  {
+    EXPECT_EQ( view.optionsByArgvPosition[i].positionIndex, parsed.optionsByArgvPosition[i].positionIndex );
+    EXPECT_EQ( view.optionsByArgvPosition[i].key, parsed.optionsByArgvPosition[i].key );
+    EXPECT_EQ( view.optionsByArgvPosition[i].occurrenceIndex, parsed.optionsByArgvPosition[i].occurrenceIndex );
+  }
+  EXPECT_EQ( view.getLatestValue( getOptions().handle( SerializeEnum::eShortB ) ), "b3" );
+
+  // Handed to a child process through a memfd.
+  const int fd{ lb::options::writeMemfd( blob ) };
+  const pid_t child{ ::fork() };
+  ASSERT_GE( child, 0 );
+  if ( child == 0 )
+  {
+    ::_exit( checkInChild( fd ) );
+  }
+  int status{ 0 };
+  ::waitpid( child, &status, 0 );
+  ::close( fd );
+  EXPECT_TRUE( WIFEXITED( status ) );
+  EXPECT_EQ( WEXITSTATUS( status ), 0 );
+}
+
+
+void testSerializeErrors()
+{
+  const auto blob{ lb::options::serialize( parseExample() ) };
+  using Serialized = lb::options::SerializedOptions<SerializeEnum>;
+
+  EXPECT_THROW( ( Serialized{ blob.data(), 8 } ), std::runtime_error );
+  EXPECT_THROW( ( Serialized{ blob.data(), blob.size() - 1 } ), std::runtime_error );
+
+  auto corrupt{ blob };
+  corrupt[0] = 'X';
+  EXPECT_THROW( ( Serialized{ corrupt.data(), corrupt.size() } ), std::runtime_error );
+
+  // The executable's string runs off the end of the string table.
+  corrupt = blob;
+  const lb::options::SerializedLayout<SerializeEnum> layout{ *reinterpret_cast<const lb::options::SerializedHeader*>( blob.data() ) };
+  lb::options::storeUint32( corrupt.data() + layout.values + 4, 1000 );
+  EXPECT_THROW( ( Serialized{ corrupt.data(), corrupt.size() } ), std::runtime_error );
+
+  // The wrong key type.
+  EXPECT_THROW( ( lb::options::SerializedOptions<std::uint8_t>{ blob.data(), blob.size() } ), std::runtime_error );
+}
+
+
+// The subcommand's result goes along too, and is rebuilt against the
+// subcommand's options.
+void testSerializeSubcommand()
+{
+  lb::options::Options<SerializeEnum> options
+  {
+    { SerializeEnum::eShortA, 'a', {}, 0, 0, "A short option that requires no arguments." },
+  };
+  options.addSubcommand( "run", []()
+  {
+    return lb::options::Options<SerializeEnum>
+    {
+      { SerializeEnum::eLongA, '\0', "long-option-a", 1, 1, "A long option with a default.", { "default-a" } },
+      { SerializeEnum::eLongB, '\0', "long-option-b", 1, 1, "A long option that requires a single argument." },
+    };
+  } );
+
+  const char* argv[5]{ { "exe" }, { "-a" }, { "run" }, { "--long-option-b" }, { "b" } };
+  const auto parsed{ options.parse( 5, const_cast<char**>( argv ) ) };
+  const auto blob{ lb::options::serialize( parsed ) };
+
+  const lb::options::SerializedOptions<SerializeEnum> serialized{ blob.data(), blob.size() };
+  EXPECT_TRUE( serialized.isPresent( SerializeEnum::eShortA ) );
+  EXPECT_FALSE( serialized.isPresent( SerializeEnum::eLongB ) );
+  const auto subcommand{ serialized.getSubcommand() };
+  ASSERT_TRUE( subcommand );
+  EXPECT_EQ( subcommand->getExecutable(), "run" );
+  EXPECT_EQ( subcommand->getLatestValue( SerializeEnum::eLongB ), "b" );
+  EXPECT_EQ( subcommand->getLatestValue( SerializeEnum::eLongA ), "default-a" );
+  EXPECT_FALSE( subcommand->getSubcommand() );
+
+  lb::options::ParsedOptionsView<SerializeEnum> view;
+  serialized.viewInto( options, view );
+  EXPECT_EQ( view.getSubcommandPath(), parsed.getSubcommandPath() );
+  ASSERT_TRUE( view.subcommand );
+  EXPECT_EQ( view.subcommand->getLatestValue( SerializeEnum::eLongB ), "b" );
+  EXPECT_EQ( view.subcommand->optionsByArgvPosition.size(), 1 );
+
+  // Without the subcommand to rebuild it against.
+  EXPECT_THROW( serialized.viewInto( getOptions(), view ), std::runtime_error );
+
+  // A corrupt subcommand blob is caught up front.
+  auto corrupt{ blob };
+  const lb::options::SerializedLayout<SerializeEnum> layout{ *reinterpret_cast<const lb::options::SerializedHeader*>( blob.data() ) };
+  corrupt[layout.subcommand] = 'X';
+  EXPECT_THROW( ( lb::options::SerializedOptions<SerializeEnum>{ corrupt.data(), corrupt.size() } ), std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, Serialize)
+{
+  testSerialize();
+  testSerializeErrors();
+  testSerializeSubcommand();
+}
@@ -0,0 +1,152 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <lb/options/Options.h>
+#include <lb/options/Snapshot.h>
+
+
+namespace
+{
+
+
+enum class SnapshotEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+  eEnvironment,
+};
+
+
+lb::options::Options<SnapshotEnum> makeOptions()
+{
+  lb::options::Options<SnapshotEnum>::Configuration config;
+  config.allowAbbreviations = true;
+  config.environmentPrefix = "LB_OPTIONS_SNAPSHOT_";
+  return
+  {
+    {
+      { SnapshotEnum::eShortA     , 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+      { SnapshotEnum::eShortB     , 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+      { SnapshotEnum::eLongA      , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+      { SnapshotEnum::eLongB      , 'l' , "long-option-b", 1,  2, "A long option taking one or two arguments." },
+      { SnapshotEnum::eEnvironment, '\0', "environment"  , 1,  1, "Bound by the prefix." },
+    }
+  , config };
+}
+
+
+template< class Schema >
+void checkParse( const Schema& schema )
+{
+  const char* argv[8]{ { "exe" }, { "-ab" }, { "b1" }, { "b2" }, { "--long-option-b" }, { "x" }, { "y" }, { "z" } };
+  const auto parsed{ schema.parse( 8, const_cast<char**>( argv ) ) };
+  EXPECT_TRUE( parsed.isPresent( SnapshotEnum::eShortA ) );
+  EXPECT_EQ( parsed.optionsByKey.at( SnapshotEnum::eShortB ).occurrences.front().values
+           , ( std::vector<std::string>{ "b1", "b2" } ) );
+  EXPECT_EQ( parsed.getLatestValue( SnapshotEnum::eLongA ), "default-a" );
+  EXPECT_EQ( parsed.getLatestValue( SnapshotEnum::eLongB ), "y" );
+  EXPECT_EQ( parsed.trailingValues, ( std::vector<std::string>{ "z" } ) );
+  EXPECT_EQ( parsed.getLatestValue( SnapshotEnum::eEnvironment ), "from-environment" );
+
+  // Abbreviations, unambiguous or not.
+  const char* abbreviated[3]{ { "exe" }, { "--long-option-a" }, { "a" } };
+  EXPECT_EQ( schema.parse( 3, const_cast<char**>( abbreviated ) ).getLatestValue( SnapshotEnum::eLongA ), "a" );
+  abbreviated[1] = "--env";
+  EXPECT_EQ( schema.parse( 3, const_cast<char**>( abbreviated ) ).getLatestValue( SnapshotEnum::eEnvironment ), "a" );
+  abbreviated[1] = "--long";
+  EXPECT_THROW( schema.parse( 3, const_cast<char**>( abbreviated ) ), std::runtime_error );
+  abbreviated[1] = "--unknown";
+  EXPECT_THROW( schema.parse( 3, const_cast<char**>( abbreviated ) ), std::runtime_error );
+}
+
+
+void testSnapshot()
+{
+  ::setenv( "LB_OPTIONS_SNAPSHOT_ENVIRONMENT", "from-environment", 1 );
+
+  const auto options{ makeOptions() };
+  const auto blob{ lb::options::writeSnapshot( options ) };
+  const lb::options::OptionsSnapshot<SnapshotEnum> snapshot{ blob.data(), blob.size() };
+
+  EXPECT_EQ( snapshot.size(), options.size() );
+  EXPECT_TRUE( snapshot.getConfiguration().allowAbbreviations );
+  EXPECT_EQ( snapshot.getDefinition( SnapshotEnum::eLongB ).l.view(), "long-option-b" );
+  EXPECT_EQ( snapshot.getDefinition( SnapshotEnum::eLongB ).maxNumValues, 2 );
+  for ( const auto key : { SnapshotEnum::eShortA, SnapshotEnum::eLongA, SnapshotEnum::eEnvironment } )
+  {
+    EXPECT_EQ( snapshot.handle( key ).slot, options.handle( key ).slot );
+  }
+  checkParse( options );
+  checkParse( snapshot );
+
+  // Nothing in a snapshot depends on where it is.
+  std::vector<std::uint64_t> moved( blob.size() / sizeof( std::uint64_t ) + 1 );
+  std::memcpy( moved.data(), blob.data(), blob.size() );
+  checkParse( lb::options::OptionsSnapshot<SnapshotEnum>{ reinterpret_cast<const char*>( moved.data() ), blob.size() } );
+
+  // Or mapped from a file.
+  char path[]{ "/tmp/lbOptionsSnapshotXXXXXX" };
+  const int fd{ ::mkstemp( path ) };
+  ASSERT_NE( fd, -1 );
+  ::close( fd );
+  std::ofstream{ path, std::ios::binary }.write( blob.data(), blob.size() );
+  checkParse( lb::options::OptionsSnapshot<SnapshotEnum>{ std::string{ path } } );
+  ::unlink( path );
+
+  ::unsetenv( "LB_OPTIONS_SNAPSHOT_ENVIRONMENT" );
+
+  // Anything that is not a snapshot for this key is refused.
+  using Snapshot = lb::options::OptionsSnapshot<SnapshotEnum>;
+  EXPECT_THROW( ( Snapshot{ blob.data(), blob.size() - 1 } ), std::runtime_error );
+  EXPECT_THROW( ( Snapshot{ reinterpret_cast<const char*>( moved.data() ) + 1, blob.size() - 1 } ), std::runtime_error );
+  EXPECT_THROW( ( lb::options::OptionsSnapshot<std::uint8_t>{ blob.data(), blob.size() } ), std::runtime_error );
+  auto corrupt{ blob };
+  corrupt[0] ^= 1;
+  EXPECT_THROW( ( Snapshot{ corrupt.data(), corrupt.size() } ), std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, Snapshot)
+{
+  testSnapshot();
+}
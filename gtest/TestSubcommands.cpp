@@ -0,0 +1,221 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <lb/options/Options.h>
+
+
+namespace
+{
+
+
+enum class SubcommandEnum
+{
+  eVerbose,
+  eOutput,
+  eMessage,
+  eAll,
+  eName,
+};
+
+
+struct Builds
+{
+  int commit{ 0 };
+  int remote{ 0 };
+  int add{ 0 };
+};
+
+
+lb::options::Options<SubcommandEnum> makeOptions( Builds& builds )
+{
+  lb::options::Options<SubcommandEnum> options
+  {
+    { SubcommandEnum::eVerbose, 'v', "verbose", 0, 0, "Say more." },
+    { SubcommandEnum::eOutput , 'o', "output" , 1, 1, "Where to write.", { "-" } },
+  };
+
+  options.addSubcommand( "commit", [&builds]()
+  {
+    ++builds.commit;
+    return lb::options::Options<SubcommandEnum>
+    {
+      { SubcommandEnum::eMessage, 'm', "message", 1, 1, "The message." },
+      { SubcommandEnum::eAll    , 'a', "all"    , 0, 0, "Everything." },
+      // Keys and flags only need be distinct within one set of options.
+      { SubcommandEnum::eVerbose, 'v', "verbose", 0, 0, "Say more about the commit." },
+    };
+  } );
+
+  options.addSubcommand( "remote", [&builds]()
+  {
+    ++builds.remote;
+    lb::options::Options<SubcommandEnum> remote
+    {
+      { SubcommandEnum::eVerbose, 'v', "verbose", 0, 0, "List with URLs." },
+    };
+    remote.addSubcommand( "add", [&builds]()
+    {
+      ++builds.add;
+      return lb::options::Options<SubcommandEnum>
+      {
+        { SubcommandEnum::eName, 'n', "name", 1, 1, "The name.", { "origin" } },
+      };
+    } );
+    return remote;
+  } );
+
+  options.addSubcommand( "broken", []()
+  {
+    return lb::options::Options<SubcommandEnum>
+    {
+      { SubcommandEnum::eAll, 'a', {}, 0, 0, "One." },
+      { SubcommandEnum::eName, 'a', {}, 0, 0, "Clashes with one." },
+    };
+  } );
+
+  return options;
+}
+
+
+void testSubcommands()
+{
+  Builds builds;
+  const auto options{ makeOptions( builds ) };
+  EXPECT_EQ( builds.commit + builds.remote + builds.add, 0 );
+
+  const char* argv[7]{ { "exe" }, { "-v" }, { "commit" }, { "-m" }, { "fix" }, { "-av" }, { "" } };
+  auto parsed{ options.parse( 6, const_cast<char**>( argv ) ) };
+  EXPECT_TRUE( parsed.isPresent( SubcommandEnum::eVerbose ) );
+  EXPECT_EQ( parsed.getLatestValue( SubcommandEnum::eOutput ), "-" );
+  EXPECT_FALSE( parsed.isPresent( SubcommandEnum::eMessage ) );
+  ASSERT_TRUE( parsed.subcommand );
+  EXPECT_EQ( parsed.getSubcommandPath(), ( std::vector<std::string_view>{ "commit" } ) );
+  EXPECT_EQ( parsed.subcommand->executable, "commit" );
+  EXPECT_EQ( parsed.subcommand->getLatestValue( SubcommandEnum::eMessage ), "fix" );
+  EXPECT_TRUE( parsed.subcommand->isPresent( SubcommandEnum::eAll ) );
+  EXPECT_TRUE( parsed.subcommand->isPresent( SubcommandEnum::eVerbose ) );
+  EXPECT_EQ( parsed.subcommand->optionsByArgvPosition.front().positionIndex, 1 );
+  EXPECT_EQ( builds.commit, 1 );
+  EXPECT_EQ( builds.remote, 0 );
+
+  // Copies are deep.
+  const auto copy{ parsed };
+  EXPECT_NE( copy.subcommand.get(), parsed.subcommand.get() );
+  EXPECT_EQ( copy.subcommand->getLatestValue( SubcommandEnum::eMessage ), "fix" );
+
+  // Built once only.
+  options.parseInto( parsed, 6, const_cast<char**>( argv ) );
+  EXPECT_EQ( builds.commit, 1 );
+
+  // Nested, with trailing values and defaults at the innermost level.
+  const char* nested[5]{ { "exe" }, { "remote" }, { "-v" }, { "add" }, { "url" } };
+  options.parseInto( parsed, 5, const_cast<char**>( nested ) );
+  EXPECT_EQ( parsed.getSubcommandPath(), ( std::vector<std::string_view>{ "remote", "add" } ) );
+  EXPECT_TRUE( parsed.subcommand->isPresent( SubcommandEnum::eVerbose ) );
+  EXPECT_EQ( parsed.subcommand->subcommand->getLatestValue( SubcommandEnum::eName ), "origin" );
+  EXPECT_EQ( parsed.subcommand->subcommand->trailingValues, ( std::vector<std::string>{ "url" } ) );
+  EXPECT_EQ( builds.commit + builds.remote + builds.add, 3 );
+
+  // A value is not a subcommand, and there need not be one.
+  const char* value[3]{ { "exe" }, { "-o" }, { "commit" } };
+  options.parseInto( parsed, 3, const_cast<char**>( value ) );
+  EXPECT_EQ( parsed.getLatestValue( SubcommandEnum::eOutput ), "commit" );
+  EXPECT_FALSE( parsed.subcommand );
+
+  // The first positional argument must name a subcommand.
+  const char* unknown[2]{ { "exe" }, { "frobnicate" } };
+  EXPECT_THROW( options.parse( 2, const_cast<char**>( unknown ) ), std::runtime_error );
+
+  // Misconfiguration shows up when the subcommand is first used.
+  const char* broken[2]{ { "exe" }, { "broken" } };
+  EXPECT_THROW( options.parse( 2, const_cast<char**>( broken ) ), std::runtime_error );
+  EXPECT_THROW( options.parse( 2, const_cast<char**>( broken ) ), std::runtime_error );
+
+  // Parses racing to a subcommand build it once between them.
+  Builds racing;
+  const auto fresh{ makeOptions( racing ) };
+  std::vector<std::thread> threads;
+  for ( int t = 0; t < 4; ++t )
+  {
+    threads.emplace_back( [&fresh, &argv]()
+    {
+      const auto result{ fresh.parse( 6, const_cast<char**>( argv ) ) };
+      EXPECT_EQ( result.subcommand->getLatestValue( SubcommandEnum::eMessage ), "fix" );
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+  EXPECT_EQ( racing.commit, 1 );
+
+  auto other{ makeOptions( builds ) };
+  EXPECT_THROW( other.addSubcommand( "commit", []() { return lb::options::Options<SubcommandEnum>{}; } ), std::runtime_error );
+  EXPECT_THROW( other.addSubcommand( "-x", []() { return lb::options::Options<SubcommandEnum>{}; } ), std::runtime_error );
+}
+
+
+// Subcommand factories return their options by value so copies and moves
+// must not refer back into the original.
+void testCopiedOptions()
+{
+  Builds builds;
+  auto original{ std::make_unique< lb::options::Options<SubcommandEnum> >( makeOptions( builds ) ) };
+  const lb::options::Options<SubcommandEnum> copy{ *original };
+  lb::options::Options<SubcommandEnum> moved{ std::move( *original ) };
+  original.reset();
+
+  const char* argv[4]{ { "exe" }, { "-v" }, { "remote" }, { "add" } };
+  for ( const auto* options : { &copy, &std::as_const( moved ) } )
+  {
+    const auto parsed{ options->parse( 4, const_cast<char**>( argv ) ) };
+    EXPECT_TRUE( parsed.isPresent( SubcommandEnum::eVerbose ) );
+    EXPECT_EQ( parsed.getLatestValue( SubcommandEnum::eOutput ), "-" );
+    EXPECT_EQ( parsed.subcommand->subcommand->getLatestValue( SubcommandEnum::eName ), "origin" );
+    EXPECT_EQ( options->getDefinition( SubcommandEnum::eOutput ).l, "output" );
+  }
+  EXPECT_EQ( builds.remote, 1 ); // The copies share their subcommands
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, Subcommands)
+{
+  testSubcommands();
+  testCopiedOptions();
+}
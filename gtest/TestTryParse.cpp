@@ -0,0 +1,129 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <lb/options/Options.h>
+#include <lb/options/ParseError.h>
+
+
+namespace
+{
+
+
+enum class TryParseEnum
+{
+  eShortA,
+  eShortB,
+  eLongA,
+  eLongB,
+};
+
+
+const lb::options::Options<TryParseEnum>& getOptions()
+{
+  static const lb::options::Options<TryParseEnum> options
+  {
+    { TryParseEnum::eShortA, 'a' , {}             , 0,  0, "A short option that requires no arguments." },
+    { TryParseEnum::eShortB, 'b' , {}             , 1, -1, "A short option that requires at least one argument." },
+    { TryParseEnum::eLongA , '\0', "long-option-a", 1,  1, "A long option with a default.", { "default-a" } },
+    { TryParseEnum::eLongB , '\0', "long-option-b", 2,  2, "A long option that requires two arguments." },
+  };
+  return options;
+}
+
+
+// The error for \a argv, checking the throwing parse agrees.
+template< int N >
+lb::options::ParseError tryParse( const char* (&argv)[N] )
+{
+  const auto result{ getOptions().tryParse( N, const_cast<char**>( argv ) ) };
+  EXPECT_FALSE( result );
+  try
+  {
+    getOptions().parse( N, const_cast<char**>( argv ) );
+    ADD_FAILURE() << "No exception for " << describe( result.getError() );
+  }
+  catch ( const std::runtime_error& e )
+  {
+    EXPECT_EQ( describe( result.getError() ), e.what() );
+  }
+  return result.getError();
+}
+
+
+void testTryParse()
+{
+  using lb::options::ParseErrorCode;
+
+  const char* good[5]{ { "exe" }, { "-a" }, { "--long-option-b" }, { "x" }, { "y" } };
+  auto result{ getOptions().tryParse( 5, const_cast<char**>( good ) ) };
+  ASSERT_TRUE( result );
+  EXPECT_EQ( result->getLatestValue( TryParseEnum::eLongB ), "y" );
+  EXPECT_EQ( ( *result ).getLatestValue( TryParseEnum::eLongA ), "default-a" );
+
+  const char* unknownShort[3]{ { "exe" }, { "-a" }, { "-ax" } };
+  auto error{ tryParse( unknownShort ) };
+  EXPECT_EQ( error.code, ParseErrorCode::eUnknownShortOption );
+  EXPECT_EQ( error.argvIndex, 2 );
+  EXPECT_EQ( error.flag, "x" );
+
+  const char* unknownLong[3]{ { "exe" }, { "b" }, { "--long-option-c" } };
+  error = tryParse( unknownLong );
+  EXPECT_EQ( error.code, ParseErrorCode::eUnknownLongOption );
+  EXPECT_EQ( error.argvIndex, 2 );
+  EXPECT_EQ( error.flag, "long-option-c" );
+
+  // Reported against the option that is short of values, not where that shows.
+  const char* tooFew[4]{ { "exe" }, { "--long-option-b" }, { "x" }, { "-a" } };
+  error = tryParse( tooFew );
+  EXPECT_EQ( error.code, ParseErrorCode::eTooFewValues );
+  EXPECT_EQ( error.argvIndex, 1 );
+  EXPECT_EQ( error.flag, "long-option-b" );
+
+  const char* tooMany[6]{ { "exe" }, { "-a" }, { "--long-option-a" }, { "1" }, { "2" }, { "-a" } };
+  error = tryParse( tooMany );
+  EXPECT_EQ( error.code, ParseErrorCode::eTooManyValues );
+  EXPECT_EQ( error.argvIndex, 2 );
+  EXPECT_EQ( error.flag, "long-option-a" );
+
+  const char* empty[1]{ { "exe" } };
+  EXPECT_EQ( getOptions().tryParse( 0, const_cast<char**>( empty ) ).getError().code, ParseErrorCode::eEmptyCommandLine );
+  EXPECT_THROW( getOptions().tryParse( 0, const_cast<char**>( empty ) ).getValue(), std::runtime_error );
+}
+
+
+} // End of anonymous namespace
+
+
+TEST(Options, TryParse)
+{
+  testTryParse();
+}
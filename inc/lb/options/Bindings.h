@@ -0,0 +1,267 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_BINDINGS_H
+#define LIB_LB_OPTIONS_BINDINGS_H
+
+#include <charconv>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief True if \a T is a std::vector. */
+template< class T >
+struct IsVector : std::false_type {};
+
+template< class T, class Allocator >
+struct IsVector< std::vector<T, Allocator> > : std::true_type {};
+
+
+/** \brief Convert an option \a value to a T.
+    \throw std::runtime_error if \a value is not a valid T, naming \a flag
+           unless it is empty
+
+    A T may be std::string, bool (true, false, 1 or 0) or any arithmetic type,
+    read with std::from_chars.
+ */
+template< class T >
+T convertValue( std::string_view value, std::string_view flag )
+{
+  if constexpr ( std::is_same_v<T, std::string> )
+  {
+    return T{ value };
+  }
+  else
+  {
+    T converted{};
+    bool isValid{ false };
+    if constexpr ( std::is_same_v<T, bool> )
+    {
+      isValid = ( value == "true" ) || ( value == "1" ) || ( value == "false" ) || ( value == "0" );
+      converted = ( value == "true" ) || ( value == "1" );
+    }
+    else
+    {
+      static_assert( std::is_arithmetic_v<T>, "Only strings, bools and arithmetic types can be bound" );
+      const auto End{ value.data() + value.size() };
+      const auto [ptr, ec]{ std::from_chars( value.data(), End, converted ) };
+      isValid = ( ec == std::errc{} ) && ( ptr == End );
+    }
+    if ( !isValid )
+    {
+      std::string message{ "Invalid value " };
+      message.append( value );
+      if ( !flag.empty() )
+      {
+        message.append( " for option " ).append( flag );
+      }
+      throw std::runtime_error{ message };
+    }
+    return converted;
+  }
+}
+
+
+/** \brief Where the options of a parse go, a handler for Options::parse that
+           converts each value straight into a bound variable.
+
+    For when a program reads its options into variables anyway, this saves
+    building a ParsedOptions and then looking each option up and converting
+    it. Bind the variables once then parse with Options::parse( argc, argv,
+    bindings ) as often as needed:
+    - a std::string, bool or arithmetic variable takes the option's last
+      value, a bool is also set to true by the option being given at all
+    - a std::vector of one of those gets every value of every occurrence
+      appended to it, so clear it first if reusing it
+    - anything callable with a std::string_view is called with each value
+
+    An option left out that has defaults gets them as if they were given,
+    variables of options left out without defaults are not touched. Options
+    that are not bound are ignored.
+
+    \throw std::runtime_error from the parse if a value does not convert, see
+           convertValue. The variables bound must outlive the parses.
+ */
+template< class Key, class Hash = std::hash<Key> >
+class Bindings
+{
+public:
+  /** \brief Bind \a key to \a destination, replacing any previous binding. */
+  template< class T >
+  Bindings& bind( Key key, T& destination );
+
+  /** \brief Call \a f with each value of \a key. */
+  Bindings& bind( Key key, std::function<void( std::string_view )> f );
+
+  /** \brief Add the trailing values to \a destination. */
+  Bindings& bindTrailing( std::vector<std::string>& destination );
+
+  // The handler interface, see IsParseHandler.
+  void onOption( const Key& key, std::string_view flag, std::size_t argvIndex );
+  void onValue( const Key& key, std::string_view value );
+  void onTrailing( std::string_view value );
+  template< class Values >
+  void onDefault( const Key& key, const Values& values );
+
+private:
+  struct Binding
+  {
+    std::function<void()> onOption; //!< May be empty
+    std::function<void( std::string_view value, std::string_view flag )> onValue;
+  };
+
+  std::unordered_map<Key, Binding, Hash> bindings;
+  std::vector<std::string>* trailingValues{ nullptr };
+
+  // That of the option last started, so its values need no lookup.
+  const Binding* current{ nullptr };
+  std::string_view currentFlag;
+};
+
+
+template< class Key, class Hash >
+template< class T >
+Bindings<Key, Hash>& Bindings<Key, Hash>::bind( Key key, T& destination )
+{
+  Binding binding;
+  if constexpr ( std::is_invocable_v<T&, std::string_view> )
+  {
+    binding.onValue = [&destination]( std::string_view value, std::string_view ) { destination( value ); };
+  }
+  else if constexpr ( IsVector<T>::value )
+  {
+    binding.onValue = [&destination]( std::string_view value, std::string_view flag )
+    {
+      destination.push_back( convertValue<typename T::value_type>( value, flag ) );
+    };
+  }
+  else
+  {
+    if constexpr ( std::is_same_v<T, bool> )
+    {
+      binding.onOption = [&destination]() { destination = true; };
+    }
+    binding.onValue = [&destination]( std::string_view value, std::string_view flag )
+    {
+      destination = convertValue<T>( value, flag );
+    };
+  }
+  bindings.insert_or_assign( std::move( key ), std::move( binding ) );
+  return *this;
+}
+
+
+template< class Key, class Hash >
+Bindings<Key, Hash>& Bindings<Key, Hash>::bind( Key key, std::function<void( std::string_view )> f )
+{
+  Binding binding;
+  binding.onValue = [f = std::move( f )]( std::string_view value, std::string_view ) { f( value ); };
+  bindings.insert_or_assign( std::move( key ), std::move( binding ) );
+  return *this;
+}
+
+
+template< class Key, class Hash >
+Bindings<Key, Hash>& Bindings<Key, Hash>::bindTrailing( std::vector<std::string>& destination )
+{
+  trailingValues = &destination;
+  return *this;
+}
+
+
+template< class Key, class Hash >
+void Bindings<Key, Hash>::onOption( const Key& key, std::string_view flag, std::size_t )
+{
+  const auto I{ bindings.find( key ) };
+  current = ( I != bindings.end() ) ? &I->second : nullptr;
+  currentFlag = flag;
+  if ( current && current->onOption )
+  {
+    current->onOption();
+  }
+}
+
+
+template< class Key, class Hash >
+void Bindings<Key, Hash>::onValue( const Key&, std::string_view value )
+{
+  if ( current )
+  {
+    current->onValue( value, currentFlag );
+  }
+}
+
+
+template< class Key, class Hash >
+void Bindings<Key, Hash>::onTrailing( std::string_view value )
+{
+  if ( trailingValues )
+  {
+    trailingValues->emplace_back( value );
+  }
+}
+
+
+template< class Key, class Hash >
+template< class Values >
+void Bindings<Key, Hash>::onDefault( const Key& key, const Values& values )
+{
+  const auto I{ bindings.find( key ) };
+  if ( I == bindings.end() )
+  {
+    return;
+  }
+  for ( const auto& value : values )
+  {
+    I->second.onValue( std::string_view{ value }, {} );
+  }
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_BINDINGS_H
@@ -0,0 +1,168 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_CONFIGFILE_H
+#define LIB_LB_OPTIONS_CONFIGFILE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief Splits the contents of an INI style config file into settings, one
+           line at a time.
+
+    The format is
+    - one setting per line, name = values, or just name for an option that
+      takes no values
+    - the values are split as a response file's arguments are, see
+      ResponseFileTokenizer, so may be quoted
+    - a line starting with # or ; is a comment, blank lines are skipped
+    - a [section] line starts a section, names within it are looked up as
+      section.name
+
+    Whitespace around names, values and section names is ignored.
+ */
+class ConfigFileReader
+{
+public:
+  struct Setting
+  {
+    std::string_view section; //!< Empty before the first [section]
+    std::string_view name;
+    char* valuesBegin;        //!< Everything after the =, for ResponseFileTokenizer
+    char* valuesEnd;
+    std::size_t lineNumber;   //!< Counting from 1
+  };
+
+  ConfigFileReader( char* begin, char* end )
+    : read{ begin }, end{ end } {}
+
+  /** \brief Get the next setting.
+      \return False once the buffer is exhausted.
+      \throw std::runtime_error on an unterminated section or a missing name.
+   */
+  bool next( Setting& setting );
+
+  /** \brief The number of the line last read, counting from 1. */
+  std::size_t getLineNumber() const { return lineNumber; }
+
+private:
+  static bool isSpace( char c )
+  {
+    return ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) || ( c == '\f' ) || ( c == '\v' );
+  }
+
+  static std::string_view trim( const char* begin, const char* end )
+  {
+    while ( ( begin != end ) && isSpace( *begin ) )
+    {
+      ++begin;
+    }
+    while ( ( begin != end ) && isSpace( end[-1] ) )
+    {
+      --end;
+    }
+    return std::string_view( begin, end - begin );
+  }
+
+  char* read;
+  char* const end;
+  std::string_view section;
+  std::size_t lineNumber{ 0 };
+};
+
+
+inline bool ConfigFileReader::next( Setting& setting )
+{
+  while ( read != end )
+  {
+    char* const lineBegin{ read };
+    while ( ( read != end ) && ( *read != '\n' ) )
+    {
+      ++read;
+    }
+    char* const lineEnd{ read };
+    if ( read != end )
+    {
+      ++read;
+    }
+    ++lineNumber;
+
+    const std::string_view line{ trim( lineBegin, lineEnd ) };
+    if ( line.empty() || ( line[0] == '#' ) || ( line[0] == ';' ) )
+    {
+      continue;
+    }
+
+    if ( line[0] == '[' )
+    {
+      if ( line.back() != ']' )
+      {
+        throw std::runtime_error( "Unterminated section in config file" );
+      }
+      section = trim( line.data() + 1, line.data() + line.size() - 1 );
+      continue;
+    }
+
+    const auto Equals{ line.find( '=' ) };
+    const char* const nameEnd{ Equals == std::string_view::npos ? line.data() + line.size()
+                                                                : line.data() + Equals };
+    setting.section = section;
+    setting.name = trim( line.data(), nameEnd );
+    if ( setting.name.empty() )
+    {
+      throw std::runtime_error( "Missing name in config file" );
+    }
+    setting.valuesBegin = lineBegin + ( nameEnd - lineBegin );
+    if ( Equals != std::string_view::npos )
+    {
+      ++setting.valuesBegin;
+    }
+    setting.valuesEnd = setting.valuesBegin + ( ( line.data() + line.size() ) - setting.valuesBegin );
+    setting.lineNumber = lineNumber;
+    return true;
+  }
+  return false;
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_CONFIGFILE_H
@@ -0,0 +1,354 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_CONSTEXPROPTIONS_H
+#define LIB_LB_OPTIONS_CONSTEXPROPTIONS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <lb/options/EnumCount.h>
+#include <lb/options/OptionHandle.h>
+#include <lb/options/ParsedOptions.h>
+#include <lb/options/Parsing.h>
+#include <lb/options/PerfectHash.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief Compile time equivalent of OptionDefinition.
+
+    The flags and description are string literals rather than owned strings.
+    Default values are not supported as they would need storage that outlives
+    the table, use Options if you need them.
+ */
+struct ConstexprOptionDefinition
+{
+  char             s{ '\0' }; //!< short version
+  std::string_view l;       //!< long version
+
+  int minNumValues{ -1 }; //!< The minimum number of required arguments, if any
+  int maxNumValues{ -1 }; //!< The maximum number of required arguments, if any
+
+  std::string_view description; //!< Description for help output.
+};
+
+
+/** \brief Aggregates the key and the compile time option definition. */
+template< class Key >
+struct ConstexprKeyedOptionDefinition
+{
+  Key key;
+  ConstexprOptionDefinition option;
+};
+
+
+/** \brief An option table that is validated and indexed at compile time.
+
+    Declare it constexpr and every misconfiguration that the Options
+    constructor would throw for becomes a compile error instead. Short flags
+    are looked up in a 256 entry table and long flags through a perfect hash so
+    there is no setup at startup and no lookup ever walks a bucket chain.
+
+    \code
+    constexpr auto options{ lb::options::makeConstexprOptions<Key>( {
+      { Key::eVerbose, { 'v', "verbose", 0, 0, "Be chatty." } },
+      { Key::eOutput , { 'o', "output" , 1, 1, "Output file." } },
+    } ) };
+    \endcode
+
+    The Key must be a literal type, an enum class is perfect.
+ */
+template< class Key, std::size_t N, class Hash = std::hash<Key> >
+class ConstexprOptions
+{
+public:
+  static_assert( N < 0xffff, "Too many option definitions for a ConstexprOptions table." );
+
+  struct Configuration
+  {
+    bool allowTrailingValues{ true };
+    bool expandResponseFiles{ false }; //!< See Options::Configuration
+  };
+
+  using Definition = ConstexprKeyedOptionDefinition<Key>;
+
+  /** \brief Validate and index the given definitions.
+      \throw std::runtime_error on misconfiguration (a compile error when
+             constant evaluated), see the Options constructor for the rules.
+   */
+  constexpr ConstexprOptions( const Definition (&definitions)[N], Configuration = {} );
+
+  /** \brief Parse the given options, see Options::parse. */
+  ParsedOptions<Key, Hash> parse( int argc, char** argv ) const;
+
+  /** \brief Parse the given options without copying, see Options::parseView. */
+  ParsedOptionsView<Key, Hash> parseView( int argc, char** argv ) const;
+
+  /** \brief Parse the given options into an existing result, see Options::parseInto. */
+  template< class String, class Allocator >
+  void parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed, int argc, char** argv ) const;
+
+  /** \brief Look up the definition for the option given by \a key.
+      \note This is a linear search, it is not intended for hot paths.
+   */
+  constexpr const ConstexprOptionDefinition& getDefinition( Key key ) const;
+
+  /** \brief A handle for fast lookups of \a key, see Options::handle. */
+  constexpr OptionHandle handle( Key key ) const;
+
+  /** \brief The number of option definitions. */
+  constexpr std::size_t size() const { return N; }
+
+  /** \brief The position of \a definition, which must be one of ours. */
+  constexpr std::size_t slotOf( const Definition& definition ) const { return &definition - definitions.data(); }
+
+  /** \brief Look up a definition by flag.
+      \return The definition or nullptr if there is no such flag.
+   */
+  constexpr const Definition* findShort( char s ) const;
+  constexpr const Definition* findLong( std::string_view l ) const;
+
+  /** \brief Does nothing as default values are not supported. */
+  template< class F >
+  constexpr void forEachDefault( F ) const {}
+
+  /** \brief Does nothing as environment variables are not supported. */
+  template< class F >
+  constexpr void forEachFromEnvironment( F ) const {}
+
+private:
+  using Index = std::uint16_t;
+  static constexpr Index None{ static_cast<Index>( N ) };
+
+  // Half full slots keep the displacement search short.
+  static constexpr std::size_t NumSlots  { 2 * N + 1 };
+  static constexpr std::size_t NumBuckets{ N / 2 + 1 };
+
+  Configuration config{};
+  std::array< Definition, N > definitions{};
+  std::array< Index, 256 > byShort{};
+  std::array< Index, NumSlots > byLong{};
+  std::array< std::uint32_t, NumBuckets > displacements{};
+  std::uint64_t seed{ 0 };
+};
+
+
+/** \brief Helper so that only the key type need be given, N is deduced. */
+template< class Key, class Hash = std::hash<Key>, std::size_t N >
+constexpr ConstexprOptions<Key, N, Hash> makeConstexprOptions(
+  const ConstexprKeyedOptionDefinition<Key> (&definitions)[N]
+, typename ConstexprOptions<Key, N, Hash>::Configuration config = {} )
+{
+  return ConstexprOptions<Key, N, Hash>{ definitions, config };
+}
+
+
+template< class Key, std::size_t N, class Hash >
+constexpr ConstexprOptions<Key, N, Hash>::ConstexprOptions( const Definition (&init)[N]
+                                                          , Configuration c )
+  : config{ c }
+{
+  for ( std::size_t s = 0; s < byShort.size(); ++s )
+  {
+    byShort[s] = None;
+  }
+
+  // Same sanity checks as Options, any throw here is a compile error when the
+  // table is declared constexpr.
+  for ( std::size_t i = 0; i < N; ++i )
+  {
+    const auto& a{ init[i] };
+
+    if ( a.option.s == '\0' && a.option.l.empty() )
+    {
+      throw std::runtime_error( "Misconfigured option, neither short not long flag specified." );
+    }
+
+    if ( a.option.s != '\0' )
+    {
+      auto& S{ byShort[ static_cast<unsigned char>( a.option.s ) ] };
+      if ( S != None )
+      {
+        throw std::runtime_error( "Misconfigured option, short option defined twice." );
+      }
+      S = static_cast<Index>( i );
+    }
+
+    for ( std::size_t j = 0; j < i; ++j )
+    {
+      if ( !a.option.l.empty() && ( a.option.l == init[j].option.l ) )
+      {
+        throw std::runtime_error( "Misconfigured option, long option defined twice." );
+      }
+      if ( a.key == init[j].key )
+      {
+        throw std::runtime_error( "Misconfigured option, key already defined." );
+      }
+    }
+
+    if ( ( a.option.minNumValues > -1 )
+      && ( a.option.maxNumValues > -1 )
+      && ( a.option.minNumValues > a.option.maxNumValues ) )
+    {
+      throw std::runtime_error( "Misconfigured option, min > max." );
+    }
+
+    if constexpr ( hasEnumCount<Key> )
+    {
+      if ( enumIndex( a.key ) >= EnumCount<Key>::value )
+      {
+        throw std::runtime_error( "Misconfigured option, key outside EnumCount." );
+      }
+    }
+
+    definitions[i] = a;
+  }
+
+  // Perfect hash over the long flags. The hashed items are only those options
+  // with a long flag so map them back to their definition index afterwards.
+  std::array< std::uint64_t, N > hashes{};
+  std::array< std::size_t, N > items{};
+  std::size_t numLong{ 0 };
+  std::array< std::size_t, NumSlots > slots{};
+  std::array< std::size_t, 2 * ( NumBuckets + N ) + 1 > scratch{};
+
+  bool built{ false };
+  while ( !built )
+  {
+    numLong = 0;
+    for ( std::size_t i = 0; i < N; ++i )
+    {
+      if ( !definitions[i].option.l.empty() )
+      {
+        hashes[ numLong ] = hashString( definitions[i].option.l, seed );
+        items [ numLong ] = i;
+        ++numLong;
+      }
+    }
+    built = buildPerfectHash( hashes.data(), numLong
+                            , displacements.data(), NumBuckets
+                            , slots.data(), NumSlots
+                            , scratch.data(), 4096 );
+    if ( !built && ( ++seed == 16 ) )
+    {
+      throw std::runtime_error( "Could not build a perfect hash of the long options." );
+    }
+  }
+
+  for ( std::size_t s = 0; s < NumSlots; ++s )
+  {
+    byLong[s] = ( slots[s] == numLong ) ? None : static_cast<Index>( items[ slots[s] ] );
+  }
+}
+
+
+template< class Key, std::size_t N, class Hash >
+ParsedOptions<Key, Hash> ConstexprOptions<Key, N, Hash>::parse( int argc, char** argv ) const
+{
+  return parseArgv<ParsedOptions<Key, Hash>>( *this, config, argc, argv );
+}
+
+
+template< class Key, std::size_t N, class Hash >
+ParsedOptionsView<Key, Hash> ConstexprOptions<Key, N, Hash>::parseView( int argc, char** argv ) const
+{
+  return parseArgv<ParsedOptionsView<Key, Hash>>( *this, config, argc, argv );
+}
+
+
+template< class Key, std::size_t N, class Hash >
+template< class String, class Allocator >
+void ConstexprOptions<Key, N, Hash>::parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                                              , int argc
+                                              , char** argv ) const
+{
+  parseArgvInto( *this, config, argc, argv, parsed );
+}
+
+
+template< class Key, std::size_t N, class Hash >
+constexpr const ConstexprOptionDefinition& ConstexprOptions<Key, N, Hash>::getDefinition( Key key ) const
+{
+  for ( const auto& definition : definitions )
+  {
+    if ( definition.key == key )
+    {
+      return definition.option;
+    }
+  }
+  throw std::runtime_error( "Option key not found" );
+}
+
+
+template< class Key, std::size_t N, class Hash >
+constexpr OptionHandle ConstexprOptions<Key, N, Hash>::handle( Key key ) const
+{
+  for ( std::size_t i = 0; i < N; ++i )
+  {
+    if ( definitions[i].key == key )
+    {
+      return { i };
+    }
+  }
+  throw std::runtime_error( "Option key not found" );
+}
+
+
+template< class Key, std::size_t N, class Hash >
+constexpr auto ConstexprOptions<Key, N, Hash>::findShort( char s ) const -> const Definition*
+{
+  const Index i{ byShort[ static_cast<unsigned char>( s ) ] };
+  return i == None ? nullptr : &definitions[i];
+}
+
+
+template< class Key, std::size_t N, class Hash >
+constexpr auto ConstexprOptions<Key, N, Hash>::findLong( std::string_view l ) const -> const Definition*
+{
+  const Index i{ byLong[ perfectHashLookup( hashString( l, seed ), displacements.data(), NumBuckets, NumSlots ) ] };
+  return ( i == None ) || ( definitions[i].option.l != l ) ? nullptr : &definitions[i];
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_CONSTEXPROPTIONS_H
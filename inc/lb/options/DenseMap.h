@@ -0,0 +1,348 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_DENSEMAP_H
+#define LIB_LB_OPTIONS_DENSEMAP_H
+
+#include <lb/options/EnumCount.h>
+
+#include <bitset>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief A map from an enum key (see EnumCount) to \a Value held in a flat
+           array indexed by the key's underlying value.
+
+    Provides the parts of the std::unordered_map interface used on
+    ParsedOptions::optionsByKey. A lookup is a bit test and an indexed load and
+    iteration is a linear scan visiting the present keys in ascending order.
+
+    Every key has its value constructed up front, an absent key's value is kept
+    empty rather than destroyed. This does mean that references and iterators
+    to a value stay valid for the lifetime of the map.
+
+    Moving from a map takes its storage whole, leaving it empty and without
+    any, which is only made again if something is added or assigned to it.
+ */
+template< class Key, class Value, class Allocator = std::allocator< std::pair<const Key, Value> > >
+class DenseMap
+{
+public:
+  static constexpr std::size_t Count{ EnumCount<Key>::value };
+
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = std::size_t;
+  using allocator_type = Allocator;
+
+  template< bool IsConst >
+  class Iterator;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  DenseMap() : DenseMap( allocator_type() ) {}
+  explicit DenseMap( const allocator_type& a );
+
+  DenseMap( const DenseMap& other );
+  DenseMap( DenseMap&& other ) noexcept;
+  DenseMap& operator=( const DenseMap& other );
+  DenseMap& operator=( DenseMap&& other );
+
+  allocator_type get_allocator() const { return entries.get_allocator(); }
+
+  size_type size() const { return present.count(); }
+  bool empty() const { return present.none(); }
+
+  /** \brief Does nothing, all the storage already exists. */
+  void reserve( size_type ) {}
+
+  size_type count( const Key& key ) const
+  {
+    const auto i{ enumIndex( key ) };
+    return ( i < Count ) && present[i] ? 1 : 0;
+  }
+
+        iterator find( const Key& key )       { return count( key ) ? iterator{ this, enumIndex( key ) } : end(); }
+  const_iterator find( const Key& key ) const { return count( key ) ? const_iterator{ this, enumIndex( key ) } : end(); }
+
+  /** \throw std::out_of_range if \a key is absent. */
+        Value& at( const Key& key )       { return entries[ checked( key ) ].second; }
+  const Value& at( const Key& key ) const { return entries[ checked( key ) ].second; }
+
+  /** \brief The value for \a key, which is marked present.
+      \throw std::out_of_range if \a key lies outside EnumCount.
+   */
+  Value& operator[]( const Key& key );
+
+  size_type erase( const Key& key );
+
+  /** \brief Remove everything. */
+  void clear();
+
+  /** \brief Remove everything, handing each value to \a recycle first.
+
+      \a recycle must leave the value empty but it can take or keep whatever
+      storage it likes, unlike clear() which resets each value.
+   */
+  template< class F >
+  void clear( F recycle );
+
+        iterator begin()        { return { this, next( 0 ) }; }
+  const_iterator begin()  const { return { this, next( 0 ) }; }
+  const_iterator cbegin() const { return begin(); }
+        iterator end()          { return { this, Count }; }
+  const_iterator end()    const { return { this, Count }; }
+  const_iterator cend()   const { return end(); }
+
+private:
+  using Entries = std::vector< value_type, Allocator >;
+
+  // Construct every key's value, if not done already (see the move constructor).
+  void ensureEntries();
+
+  // The first present index from \a i on, or Count.
+  size_type next( size_type i ) const
+  {
+    while ( ( i < Count ) && !present[i] )
+    {
+      ++i;
+    }
+    return i;
+  }
+
+  size_type checked( const Key& key ) const
+  {
+    if ( !count( key ) )
+    {
+      throw std::out_of_range( "DenseMap key not present" );
+    }
+    return enumIndex( key );
+  }
+
+  Entries entries;
+  std::bitset< Count > present;
+};
+
+
+template< class Key, class Value, class Allocator >
+template< bool IsConst >
+class DenseMap<Key, Value, Allocator>::Iterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename DenseMap::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t< IsConst, const value_type*, value_type* >;
+  using reference = std::conditional_t< IsConst, const value_type&, value_type& >;
+
+  Iterator() = default;
+
+  // An iterator converts to a const_iterator.
+  operator Iterator<true>() const { return { map, index }; }
+
+  reference operator*() const { return map->entries[ index ]; }
+  pointer operator->() const { return &map->entries[ index ]; }
+
+  Iterator& operator++()
+  {
+    index = map->next( index + 1 );
+    return *this;
+  }
+
+  Iterator operator++( int )
+  {
+    Iterator result{ *this };
+    ++*this;
+    return result;
+  }
+
+  bool operator==( const Iterator& other ) const { return index == other.index; }
+  bool operator!=( const Iterator& other ) const { return index != other.index; }
+
+private:
+  friend class DenseMap;
+  friend class Iterator<!IsConst>;
+
+  using Map = std::conditional_t< IsConst, const DenseMap, DenseMap >;
+
+  Iterator( Map* m, size_type i ) : map{ m }, index{ i } {}
+
+  Map* map{ nullptr };
+  size_type index{ 0 };
+};
+
+
+template< class Key, class Value, class Allocator >
+DenseMap<Key, Value, Allocator>::DenseMap( const allocator_type& a )
+  : entries( a )
+{
+  ensureEntries();
+}
+
+
+template< class Key, class Value, class Allocator >
+DenseMap<Key, Value, Allocator>::DenseMap( const DenseMap& other )
+  : DenseMap( std::allocator_traits<Allocator>::select_on_container_copy_construction( other.get_allocator() ) )
+{
+  *this = other;
+}
+
+
+template< class Key, class Value, class Allocator >
+DenseMap<Key, Value, Allocator>::DenseMap( DenseMap&& other ) noexcept
+  : entries( std::move( other.entries ) ), present( other.present )
+{
+  other.entries.clear();
+  other.present.reset();
+}
+
+
+template< class Key, class Value, class Allocator >
+void DenseMap<Key, Value, Allocator>::ensureEntries()
+{
+  if ( !entries.empty() )
+  {
+    return;
+  }
+  entries.reserve( Count );
+  for ( size_type i = 0; i < Count; ++i )
+  {
+    entries.emplace_back( std::piecewise_construct
+                        , std::forward_as_tuple( static_cast<Key>( static_cast<std::underlying_type_t<Key>>( i ) ) )
+                        , std::forward_as_tuple() );
+  }
+}
+
+
+// Absent values are empty so there is no harm in assigning them too.
+template< class Key, class Value, class Allocator >
+auto DenseMap<Key, Value, Allocator>::operator=( const DenseMap& other ) -> DenseMap&
+{
+  if ( other.entries.empty() )
+  {
+    clear();
+    return *this;
+  }
+  ensureEntries();
+  for ( size_type i = 0; i < Count; ++i )
+  {
+    entries[i].second = other.entries[i].second;
+  }
+  present = other.present;
+  return *this;
+}
+
+
+template< class Key, class Value, class Allocator >
+auto DenseMap<Key, Value, Allocator>::operator=( DenseMap&& other ) -> DenseMap&
+{
+  if ( other.entries.empty() )
+  {
+    clear();
+    return *this;
+  }
+  ensureEntries();
+  for ( size_type i = 0; i < Count; ++i )
+  {
+    entries[i].second = std::move( other.entries[i].second );
+  }
+  present = other.present;
+  other.clear();
+  return *this;
+}
+
+
+template< class Key, class Value, class Allocator >
+Value& DenseMap<Key, Value, Allocator>::operator[]( const Key& key )
+{
+  const auto i{ enumIndex( key ) };
+  if ( i >= Count )
+  {
+    throw std::out_of_range( "DenseMap key outside EnumCount" );
+  }
+  ensureEntries();
+  present.set( i );
+  return entries[i].second;
+}
+
+
+template< class Key, class Value, class Allocator >
+auto DenseMap<Key, Value, Allocator>::erase( const Key& key ) -> size_type
+{
+  if ( !count( key ) )
+  {
+    return 0;
+  }
+  const auto i{ enumIndex( key ) };
+  entries[i].second = Value();
+  present.reset( i );
+  return 1;
+}
+
+
+template< class Key, class Value, class Allocator >
+void DenseMap<Key, Value, Allocator>::clear()
+{
+  clear( []( Value& value ) { value = Value(); } );
+}
+
+
+template< class Key, class Value, class Allocator >
+template< class F >
+void DenseMap<Key, Value, Allocator>::clear( F recycle )
+{
+  for ( auto i = next( 0 ); i < Count; i = next( i + 1 ) )
+  {
+    recycle( entries[i].second );
+  }
+  present.reset();
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_DENSEMAP_H
@@ -0,0 +1,85 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_ENUMCOUNT_H
+#define LIB_LB_OPTIONS_ENUMCOUNT_H
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief Opt in to dense storage for an enum key.
+
+    Specialise this for an enum (class) whose enumerators run from 0 to
+    \a value - 1, e.g.
+
+        template<> struct lb::options::EnumCount<MyKey>
+          : std::integral_constant<std::size_t, 5> {};
+
+    and ParsedOptions stores options in a DenseMap indexed by the underlying
+    value rather than in an unordered_map, while Options looks definitions up
+    by index. Options throws if a key lies outside the range.
+ */
+template< class Key >
+struct EnumCount {};
+
+
+/** \brief True if EnumCount has been specialised for \a Key. */
+template< class Key, class = void >
+struct HasEnumCount : std::false_type {};
+
+template< class Key >
+struct HasEnumCount< Key, std::void_t< decltype( EnumCount<Key>::value ) > >
+  : std::true_type {};
+
+template< class Key >
+inline constexpr bool hasEnumCount{ HasEnumCount<Key>::value };
+
+
+/** \brief The position of \a key in dense storage, its underlying value. */
+template< class Key >
+constexpr std::size_t enumIndex( Key key )
+{
+  return static_cast<std::size_t>( static_cast<std::underlying_type_t<Key>>( key ) );
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_ENUMCOUNT_H
@@ -0,0 +1,323 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_EVENTPARSING_H
+#define LIB_LB_OPTIONS_EVENTPARSING_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <lb/options/ParseError.h>
+#include <lb/options/Parsing.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief True if \a Handler can take the events of parseEvents for options
+           keyed by \a Key.
+
+    It must have
+    - onOption( key, flag, argvIndex ) for each flag on the command line, or
+      set environment variable (its name as the flag and argvIndex 0)
+    - onValue( key, value ) for each value of the option last started
+    - onTrailing( value ) for each trailing value, once they are known to be
+      trailing
+    - onDefault( key, defaultValues ) for each option left out that has
+      defaults, with the definition's defaultValues (a
+      std::vector<std::string> for Options)
+ */
+template< class Handler, class Key, class = void >
+struct IsParseHandler : std::false_type {};
+
+template< class Handler, class Key >
+struct IsParseHandler< Handler, Key
+                     , std::void_t< decltype( std::declval<Handler&>().onOption( std::declval<const Key&>(), std::string_view{}, std::size_t{} ) )
+                                  , decltype( std::declval<Handler&>().onValue( std::declval<const Key&>(), std::string_view{} ) )
+                                  , decltype( std::declval<Handler&>().onTrailing( std::string_view{} ) )
+                                  , decltype( std::declval<Handler&>().onDefault( std::declval<const Key&>(), std::declval<const std::vector<std::string>&>() ) ) > >
+  : std::true_type {};
+
+template< class Handler, class Key >
+inline constexpr bool isParseHandler{ IsParseHandler<Handler, Key>::value };
+
+
+/** \brief A set of option slots that only allocates for more than 256. */
+class SlotSet
+{
+public:
+  explicit SlotSet( std::size_t size )
+  {
+    if ( size > 64 * inlineWords.size() )
+    {
+      heapWords = std::make_unique<std::uint64_t[]>( ( size + 63 ) / 64 );
+    }
+  }
+
+  void insert( std::size_t slot ) { words()[slot / 64] |= std::uint64_t{ 1 } << ( slot % 64 ); }
+
+  bool contains( std::size_t slot ) const
+  {
+    return ( words()[slot / 64] >> ( slot % 64 ) ) & 1;
+  }
+
+private:
+        std::uint64_t* words()       { return heapWords ? heapWords.get() : inlineWords.data(); }
+  const std::uint64_t* words() const { return heapWords ? heapWords.get() : inlineWords.data(); }
+
+  std::array<std::uint64_t, 4> inlineWords{};
+  std::unique_ptr<std::uint64_t[]> heapWords;
+};
+
+
+/** \brief Parse the command line [\a first, \a last) straight into calls on
+           \a handler, building no result.
+
+    For consumers that react to options as they stream past and do not need
+    to look them up afterwards. The rules are those of tryParseArgumentsInto,
+    with the same errors, and the events come in command line order then the
+    environment then the defaults (see IsParseHandler). Trailing values are
+    only passed on at the end, when they are known not to be in excess.
+
+    Errors are returned as by tryParseArgumentsInto, by which time the events
+    up to the error have been sent. Nothing is allocated for a \a schema of up
+    to 256 options.
+
+    Response files are not expanded and subcommands are not dispatched so
+    rather than take such arguments as values this throws std::runtime_error,
+    before any event, if \a config expands response files or \a schema has
+    subcommands. The range must be a forward one and stay valid throughout,
+    as argv does.
+ */
+template< class Schema, class Config, class Iterator, class Handler >
+ParseError tryParseEvents( const Schema& schema
+                         , const Config& config
+                         , Iterator first
+                         , Iterator last
+                         , Handler& handler )
+{
+  using Definition = typename Schema::Definition;
+
+  if ( config.expandResponseFiles )
+  {
+    throw std::runtime_error{ "Response files cannot be expanded when parsing into events" };
+  }
+  if constexpr ( supportsSubcommands<Schema> )
+  {
+    if ( schema.hasSubcommands() )
+    {
+      throw std::runtime_error{ "Subcommands cannot be dispatched when parsing into events" };
+    }
+  }
+
+  if ( first == last )
+  {
+    return { ParseErrorCode::eEmptyCommandLine };
+  }
+
+  SlotSet isPresent{ schema.size() };
+
+  // The option collecting values, as Parsing, and the run of values that
+  // are trailing or in excess depending on what follows.
+  const Definition* current{ nullptr };
+  std::string_view currentFlag;
+  std::size_t currentPosition{ 0 };
+  std::size_t numValues{ 0 };
+  Iterator pending{ last };
+  std::size_t numPending{ 0 };
+
+  auto close = [&]( bool allowExcessValues ) -> ParseError
+  {
+    if ( current )
+    {
+      if ( tooFewValues( *current, numValues ) )
+      {
+        return { ParseErrorCode::eTooFewValues, currentPosition, currentFlag };
+      }
+      if ( !allowExcessValues && ( numPending > 0 ) )
+      {
+        return { ParseErrorCode::eTooManyValues, currentPosition, currentFlag };
+      }
+    }
+    return {};
+  };
+
+  std::size_t position{ 0 };
+  auto start = [&]( const Definition& option, std::string_view flag ) -> ParseError
+  {
+    if ( const auto error{ close( false ) } )
+    {
+      return error;
+    }
+    current = &option;
+    currentFlag = flag;
+    currentPosition = position;
+    numValues = 0;
+    isPresent.insert( schema.slotOf( option ) );
+    handler.onOption( option.key, flag, position );
+    return {};
+  };
+
+  for ( auto i = std::next( first ); i != last; ++i )
+  {
+    ++position;
+    const std::string_view s{ *i };
+    if ( !s.empty() && ( s[0] == '-' ) )
+    {
+      if ( ( s.size() > 1 ) && ( s[1] == '-' ) )
+      {
+        const Definition* const L{ schema.findLong( s.substr( 2 ) ) };
+        if ( !L )
+        {
+          return { ParseErrorCode::eUnknownLongOption, position, s.substr( 2 ) };
+        }
+        if ( const auto error{ start( *L, L->option.l ) } )
+        {
+          return error;
+        }
+      }
+      else
+      {
+        for ( std::string_view::size_type j = 1; j < s.size(); ++j )
+        {
+          const Definition* const S{ schema.findShort( s[j] ) };
+          if ( !S )
+          {
+            return { ParseErrorCode::eUnknownShortOption, position, s.substr( j, 1 ), {}, j };
+          }
+          if ( const auto error{ start( *S, std::string_view{ &S->option.s, 1 } ) } )
+          {
+            return error;
+          }
+        }
+      }
+      numPending = 0;
+    }
+    else if ( current && !isFull( *current, numValues ) )
+    {
+      handler.onValue( current->key, s );
+      ++numValues;
+    }
+    else if ( numPending++ == 0 )
+    {
+      pending = i;
+    }
+  }
+
+  if ( const auto error{ close( config.allowTrailingValues ) } )
+  {
+    return error;
+  }
+  if ( config.allowTrailingValues )
+  {
+    for ( ; numPending > 0; --numPending, ++pending )
+    {
+      handler.onTrailing( std::string_view{ *pending } );
+    }
+  }
+
+  ParseError error;
+  schema.forEachFromEnvironment( [&]( const auto& option, std::string_view variable, std::string_view value )
+  {
+    const std::size_t Slot{ schema.slotOf( option ) };
+    if ( error || isPresent.contains( Slot ) )
+    {
+      return;
+    }
+    isPresent.insert( Slot );
+
+    handler.onOption( option.key, variable, 0 );
+    std::size_t count{ 0 };
+    const bool AllSent{ forEachEnvironmentValue( option, value, [&]( std::string_view v )
+    {
+      if ( isFull( option, count ) )
+      {
+        return false;
+      }
+      handler.onValue( option.key, v );
+      ++count;
+      return true;
+    } ) };
+    if ( !AllSent )
+    {
+      error = { ParseErrorCode::eTooManyValues, 0, option.option.l, variable };
+    }
+    else if ( tooFewValues( option, count ) )
+    {
+      error = { ParseErrorCode::eTooFewValues, 0, option.option.l, variable };
+    }
+  } );
+  if ( error )
+  {
+    return error;
+  }
+
+  schema.forEachDefault( [&]( const auto& option )
+  {
+    if ( !isPresent.contains( schema.slotOf( option ) ) )
+    {
+      handler.onDefault( option.key, option.option.defaultValues );
+    }
+  } );
+  return {};
+}
+
+
+/** \brief As tryParseEvents but throwing any error.
+    \throw std::runtime_error on parse failure (see Options::parse)
+ */
+template< class Schema, class Config, class Iterator, class Handler >
+void parseEvents( const Schema& schema
+                , const Config& config
+                , Iterator first
+                , Iterator last
+                , Handler& handler )
+{
+  throwIfError( tryParseEvents( schema, config, first, last, handler ) );
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_EVENTPARSING_H
@@ -0,0 +1,322 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_FLAGTRIE_H
+#define LIB_LB_OPTIONS_FLAGTRIE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief A compact radix trie mapping long flags to indices.
+
+    Besides exact lookup it resolves unambiguous abbreviations (--verb for
+    --verbose) and enumerates every flag sharing a prefix (everything under
+    --db.). All nodes, edge labels and values live in three flat arrays and a
+    lookup walks the flag in place without allocating.
+
+    Every node covers a contiguous range of the flags in sorted order so a
+    prefix query is one walk down the trie followed by a linear scan.
+ */
+class FlagTrie
+{
+public:
+  using Index = std::uint32_t;
+  static constexpr Index None{ ~Index{ 0 } };
+
+  struct Entry
+  {
+    std::string_view flag; //!< Must be non-empty
+    Index value;
+  };
+
+  FlagTrie() = default;
+
+  /** \brief Build the trie from the given flags.
+      \throw std::runtime_error if a flag is given twice.
+   */
+  explicit FlagTrie( std::vector<Entry> entries );
+
+  /** \brief The value for exactly \a flag or None. */
+  Index find( std::string_view flag ) const;
+
+  /** \brief The value for \a prefix if it is a flag or if it is the prefix of
+             exactly one flag, otherwise None.
+   */
+  Index findUnambiguous( std::string_view prefix ) const;
+
+  /** \brief Call \a f with the value of each flag starting with \a prefix, in
+             lexicographic order of the flags.
+   */
+  template< class F >
+  void forEachWithPrefix( std::string_view prefix, F f ) const;
+
+  /** \brief The number of flags. */
+  std::size_t size() const { return values.size(); }
+
+private:
+  struct Node
+  {
+    std::uint32_t labelBegin; //!< Edge label from the parent, in labels
+    std::uint32_t labelSize;
+    std::uint32_t childBegin; //!< Children are contiguous in nodes
+    std::uint32_t childCount;
+    std::uint32_t rangeBegin; //!< Flags below this node, in values
+    std::uint32_t rangeEnd;
+    Index value;              //!< Flag ending exactly here, if any
+  };
+
+  void buildChildren( const std::vector<Entry>& entries
+                    , std::uint32_t node
+                    , std::uint32_t lo
+                    , std::uint32_t hi
+                    , std::size_t depth );
+
+  std::string_view label( const Node& node ) const
+  {
+    return { labels.data() + node.labelBegin, node.labelSize };
+  }
+
+  Index findChild( const Node& node, char c ) const;
+
+  // The node below which all flags starting with \a prefix lie, or None.
+  Index locate( std::string_view prefix ) const;
+
+  std::vector< Node > nodes;
+  std::string firstChars; //!< First label character of each node, children are scanned here
+  std::string labels;
+  std::vector< Index > values;
+};
+
+
+inline FlagTrie::FlagTrie( std::vector<Entry> entries )
+{
+  std::sort( entries.begin(), entries.end()
+           , []( const Entry& lhs, const Entry& rhs ) { return lhs.flag < rhs.flag; } );
+
+  for ( std::size_t i = 1; i < entries.size(); ++i )
+  {
+    if ( entries[i].flag == entries[i - 1].flag )
+    {
+      throw std::runtime_error(
+        std::string{ "Misconfigured option, long option " }.append( entries[i].flag ).append( " defined twice." ) );
+    }
+  }
+
+  values.reserve( entries.size() );
+  for ( const auto& entry : entries )
+  {
+    values.push_back( entry.value );
+  }
+
+  nodes.reserve( 2 * entries.size() + 1 );
+  nodes.push_back( { 0, 0, 0, 0, 0, static_cast<std::uint32_t>( entries.size() ), None } );
+  buildChildren( entries, 0, 0, static_cast<std::uint32_t>( entries.size() ), 0 );
+
+  firstChars.reserve( nodes.size() );
+  for ( const auto& node : nodes )
+  {
+    firstChars.push_back( node.labelSize == 0 ? '\0' : labels[ node.labelBegin ] );
+  }
+}
+
+
+inline void FlagTrie::buildChildren( const std::vector<Entry>& entries
+                                   , std::uint32_t node
+                                   , std::uint32_t lo
+                                   , std::uint32_t hi
+                                   , std::size_t depth )
+{
+  // A flag ending exactly at this node sorts before all that continue on.
+  if ( ( lo < hi ) && ( entries[lo].flag.size() == depth ) )
+  {
+    nodes[node].value = entries[lo].value;
+    ++lo;
+  }
+
+  // Group the remaining flags by their next character, one child per group.
+  std::uint32_t childCount{ 0 };
+  for ( std::uint32_t i = lo; i < hi; ++i )
+  {
+    if ( ( i == lo ) || ( entries[i].flag[depth] != entries[i - 1].flag[depth] ) )
+    {
+      ++childCount;
+    }
+  }
+
+  const auto childBegin{ static_cast<std::uint32_t>( nodes.size() ) };
+  nodes[node].childBegin = childBegin;
+  nodes[node].childCount = childCount;
+  nodes.resize( nodes.size() + childCount );
+
+  std::uint32_t child{ childBegin };
+  for ( std::uint32_t first = lo; first < hi; ++child )
+  {
+    std::uint32_t last{ first + 1 };
+    while ( ( last < hi ) && ( entries[last].flag[depth] == entries[first].flag[depth] ) )
+    {
+      ++last;
+    }
+
+    // The flags are sorted so the common prefix of the group is that of its
+    // first and last members.
+    const std::string_view a{ entries[first].flag };
+    const std::string_view b{ entries[last - 1].flag };
+    std::size_t common{ depth + 1 };
+    while ( ( common < a.size() ) && ( common < b.size() ) && ( a[common] == b[common] ) )
+    {
+      ++common;
+    }
+
+    nodes[child] = { static_cast<std::uint32_t>( labels.size() )
+                   , static_cast<std::uint32_t>( common - depth )
+                   , 0, 0, first, last, None };
+    labels.append( a.substr( depth, common - depth ) );
+    buildChildren( entries, child, first, last, common );
+
+    first = last;
+  }
+}
+
+
+inline FlagTrie::Index FlagTrie::findChild( const Node& node, char c ) const
+{
+  // Siblings start with distinct characters so there is at most one match.
+  const char* const begin{ firstChars.data() + node.childBegin };
+  const void* const C{ std::memchr( begin, c, node.childCount ) };
+  if ( !C )
+  {
+    return None;
+  }
+  return static_cast<Index>( static_cast<const char*>( C ) - firstChars.data() );
+}
+
+
+inline FlagTrie::Index FlagTrie::find( std::string_view flag ) const
+{
+  if ( nodes.empty() )
+  {
+    return None;
+  }
+
+  Index n{ 0 };
+  for ( std::size_t pos = 0; pos < flag.size(); )
+  {
+    n = findChild( nodes[n], flag[pos] );
+    if ( n == None )
+    {
+      return None;
+    }
+    const auto l{ label( nodes[n] ) };
+    if ( flag.compare( pos, l.size(), l ) != 0 )
+    {
+      return None;
+    }
+    pos += l.size();
+  }
+  return nodes[n].value;
+}
+
+
+inline FlagTrie::Index FlagTrie::locate( std::string_view prefix ) const
+{
+  if ( nodes.empty() )
+  {
+    return None;
+  }
+
+  Index n{ 0 };
+  for ( std::size_t pos = 0; pos < prefix.size(); )
+  {
+    n = findChild( nodes[n], prefix[pos] );
+    if ( n == None )
+    {
+      return None;
+    }
+    // The prefix may end part way along the edge.
+    const auto l{ label( nodes[n] ) };
+    const auto remaining{ prefix.substr( pos ) };
+    if ( l.substr( 0, remaining.size() ) != remaining.substr( 0, l.size() ) )
+    {
+      return None;
+    }
+    pos += l.size();
+  }
+  return n;
+}
+
+
+inline FlagTrie::Index FlagTrie::findUnambiguous( std::string_view prefix ) const
+{
+  const Index exact{ find( prefix ) };
+  if ( exact != None )
+  {
+    return exact;
+  }
+  const Index n{ locate( prefix ) };
+  if ( ( n == None ) || ( nodes[n].rangeEnd - nodes[n].rangeBegin != 1 ) )
+  {
+    return None;
+  }
+  return values[ nodes[n].rangeBegin ];
+}
+
+
+template< class F >
+void FlagTrie::forEachWithPrefix( std::string_view prefix, F f ) const
+{
+  const Index n{ locate( prefix ) };
+  if ( n != None )
+  {
+    for ( auto i = nodes[n].rangeBegin; i < nodes[n].rangeEnd; ++i )
+    {
+      f( values[i] );
+    }
+  }
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_FLAGTRIE_H
@@ -0,0 +1,174 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_MAPPEDFILE_H
+#define LIB_LB_OPTIONS_MAPPEDFILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief A whole file mapped into memory.
+
+    In copy on write mode the mapping is private and writable, changes are
+    never written back but only the pages touched get copied. That is what
+    lets a response file be unquoted in place.
+ */
+class MappedFile
+{
+public:
+  enum class Mode
+  {
+    eReadOnly,
+    eCopyOnWrite,
+  };
+
+  /** \throw std::runtime_error if \a path cannot be opened or mapped. */
+  MappedFile( const std::string& path, Mode mode );
+
+  /** \brief Map the whole of the open file \a fd, e.g. a memfd, which is left
+             open for the caller to close.
+      \throw std::runtime_error if \a fd cannot be mapped.
+   */
+  MappedFile( int fd, Mode mode );
+  ~MappedFile();
+
+  MappedFile( const MappedFile& ) = delete;
+  MappedFile& operator=( const MappedFile& ) = delete;
+
+  MappedFile( MappedFile&& other ) noexcept
+    : address{ std::exchange( other.address, nullptr ) }, length{ std::exchange( other.length, 0 ) } {}
+  MappedFile& operator=( MappedFile&& other ) noexcept
+  {
+    std::swap( address, other.address );
+    std::swap( length, other.length );
+    return *this;
+  }
+
+  /** \brief The contents, writable only in copy on write mode. */
+        char* data()       { return static_cast<char*>( address ); }
+  const char* data() const { return static_cast<const char*>( address ); }
+  std::size_t size() const { return length; }
+
+  std::string_view view() const { return { data(), length }; }
+
+private:
+  // Map all of \a fd, \a name being what to call it in an error.
+  void map( int fd, Mode mode, const std::string& name );
+
+  void* address{ nullptr }; //!< Null for an empty file, which cannot be mapped
+  std::size_t length{ 0 };
+};
+
+
+inline MappedFile::MappedFile( const std::string& path, Mode mode )
+{
+  const int fd{ ::open( path.c_str(), O_RDONLY | O_CLOEXEC ) };
+  if ( fd < 0 )
+  {
+    throw std::runtime_error( "Could not open " + path + ": " + std::strerror( errno ) );
+  }
+
+  try
+  {
+    map( fd, mode, path );
+  }
+  catch ( ... )
+  {
+    ::close( fd );
+    throw;
+  }
+  // The mapping stays valid without the descriptor.
+  ::close( fd );
+}
+
+
+inline MappedFile::MappedFile( int fd, Mode mode )
+{
+  map( fd, mode, "descriptor " + std::to_string( fd ) );
+}
+
+
+inline void MappedFile::map( int fd, Mode mode, const std::string& name )
+{
+  struct stat st;
+  if ( ::fstat( fd, &st ) != 0 )
+  {
+    throw std::runtime_error( "Could not stat " + name + ": " + std::strerror( errno ) );
+  }
+
+  length = static_cast<std::size_t>( st.st_size );
+  if ( length > 0 )
+  {
+    const bool cow{ mode == Mode::eCopyOnWrite };
+    address = ::mmap( nullptr, length
+                    , cow ? PROT_READ | PROT_WRITE : PROT_READ
+                    , MAP_PRIVATE, fd, 0 );
+    if ( address == MAP_FAILED )
+    {
+      const int error{ errno };
+      address = nullptr;
+      throw std::runtime_error( "Could not map " + name + ": " + std::strerror( error ) );
+    }
+  }
+}
+
+
+inline MappedFile::~MappedFile()
+{
+  if ( address )
+  {
+    ::munmap( address, length );
+  }
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_MAPPEDFILE_H
@@ -57,6 +57,9 @@ namespace options
     they will *not* be used if the option is present but missing the required
     number of arguments, that is an error.
 
+    An option can also be bound to an environment variable that is used, when
+    set, in place of the default values.
+
     A negative value for either \a minNumValues or \a maxNumValues indiciates
     that there is no limit.
 
@@ -76,6 +79,11 @@ struct OptionDefinition
   std::string description; //!< Description for help output.
 
   std::vector< std::string > defaultValues; //! Optional default values.
+
+  /** Optional environment variable to take values from when the option is not
+      on the command line, see Options::Configuration::environmentPrefix.
+   */
+  std::string environmentVariable;
 };
 
 
@@ -30,16 +30,36 @@
 
 #include <set>
 
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <optional>
 
+#include <unistd.h>
+
+#include <lb/options/EnumCount.h>
+#include <lb/options/EventParsing.h>
+#include <lb/options/FlagTrie.h>
 #include <lb/options/KeyedOptionDefinition.h>
+#include <lb/options/OptionHandle.h>
+#include <lb/options/ParseError.h>
 #include <lb/options/ParsedOptions.h>
+#include <lb/options/Parsing.h>
+#include <lb/options/PerfectHash.h>
 
 
 namespace lb
@@ -50,6 +70,56 @@ namespace options
 {
 
 
+/** \brief The environment variable that \a prefix binds the option with long
+           flag \a l to, see Options::Configuration::environmentPrefix.
+ */
+inline std::string environmentVariableName( std::string_view prefix, std::string_view l )
+{
+  std::string variable{ prefix };
+  for ( const char c : l )
+  {
+    variable.push_back( ( c == '-' ) || ( c == '.' ) ? '_'
+                                                      : static_cast<char>( std::toupper( static_cast<unsigned char>( c ) ) ) );
+  }
+  return variable;
+}
+
+
+/** \brief The environment variable that \a option is bound to, either its own
+           or one named by \a prefix, or empty if none.
+ */
+inline std::string boundEnvironmentVariable( std::string_view prefix, const OptionDefinition& option )
+{
+  if ( option.environmentVariable.empty() && !prefix.empty() && !option.l.empty() )
+  {
+    return environmentVariableName( prefix, option.l );
+  }
+  return option.environmentVariable;
+}
+
+
+/** \brief Call \a f with ( variable, value ) for each variable in the
+           environment, the views referring into it.
+ */
+template< class F >
+void forEachEnvironmentVariable( F f )
+{
+  if ( !environ )
+  {
+    return;
+  }
+
+  for ( char** e = environ; *e; ++e )
+  {
+    const char* const equals{ std::strchr( *e, '=' ) };
+    if ( equals )
+    {
+      f( std::string_view( *e, equals - *e ), std::string_view{ equals + 1 } );
+    }
+  }
+}
+
+
 /** \brief Takes option definitions and parses an {argc.argv} set against them.
 
     The constructor takes a list of keyed option definitions. Once constructed
@@ -57,6 +127,9 @@ namespace options
     definitions. This may be done more than once if required. The result of that
     is a ParsedOptions structure that allows you to search for options by your
     chosen key and/or work through the original order.
+
+    All const methods, so every parse, are safe to call from several threads
+    at once on one instance, see parseBatch for many command lines at a time.
  */
 template< class Key, class Hash = std::hash<Key> >
 class Options
@@ -65,6 +138,27 @@ public:
   struct Configuration
   {
     bool allowTrailingValues{ true };
+    bool allowAbbreviations{ false }; //!< Accept unambiguous prefixes of long flags
+
+    /** Build minimal perfect hashes over the long flags and the keys. Exact
+        lookups then cost one hash and one compare against a flat array
+        instead of a walk or a bucket chain. Worth it for large option sets
+        that are only known at run time.
+     */
+    bool usePerfectHash{ false };
+
+    /** Replace an argument \@path with the arguments in the file at path, a
+        response file, see feedResponseFile. They are read straight from a
+        mapping of the file and parseView results refer into it.
+     */
+    bool expandResponseFiles{ false };
+
+    /** Bind every option with a long flag, and no environment variable of its
+        own, to the variable named by this followed by the long flag in upper
+        case with - and . as _, e.g. MYAPP_ and --log-level give
+        MYAPP_LOG_LEVEL. See forEachFromEnvironment.
+     */
+    std::string environmentPrefix;
   };
 
   /** \brief Construct an Options instance from a list of option definitions.
@@ -82,6 +176,23 @@ public:
   Options( std::initializer_list< KeyedOptionDefinition<Key> >
          , Configuration = {} );
 
+  /** \brief Construct an Options instance from definitions built at run time,
+             moving them into place rather than copying.
+      \throw std::runtime_error on construction failure (see above)
+   */
+  Options( std::vector< KeyedOptionDefinition<Key> >&& definitions
+         , Configuration = {} );
+
+  /** \brief Construct an Options instance from the definitions in
+             [\a first, \a last), moved if the iterators are
+             std::move_iterators and copied otherwise.
+      \throw std::runtime_error on construction failure (see above)
+   */
+  template< class Iterator
+          , class = typename std::iterator_traits<Iterator>::iterator_category >
+  Options( Iterator first, Iterator last, Configuration c = {} )
+    : Options( std::vector< KeyedOptionDefinition<Key> >( first, last ), std::move( c ) ) {}
+
   /** \brief Parse the given options into a ParsedOptions instance.
       \throw std::runtime_error on parse failure (see decsription)
 
@@ -91,41 +202,279 @@ public:
       - insuffucient number of arguments based on option definition
       - excess number of arguments based on option definition unless they could
         be interpreted as trailing arguments
+
+      An option missing from \a argv that is bound to a set environment
+      variable (see OptionDefinition::environmentVariable) takes its values
+      from that in place of its defaults.
    */
   ParsedOptions<Key, Hash> parse( int argc, char** argv ) const;
 
+  /** \brief Parse the given options into calls on \a handler rather than a
+             result.
+      \throw std::runtime_error on parse failure (see \a parse) or if
+             response files are expanded or there are subcommands, which
+             are not handled here
+
+      The handler gets onOption, onValue, onTrailing and onDefault calls as
+      the command line is read, see IsParseHandler and tryParseEvents. The
+      value count rules are enforced as for \a parse but no ParsedOptions is
+      built so nothing is allocated.
+   */
+  template< class Handler, class = std::enable_if_t< isParseHandler<Handler, Key> > >
+  void parse( int argc, char** argv, Handler& handler ) const;
+
+  /** \brief Parse the given options into a ParsedOptionsView instance.
+      \throw std::runtime_error on parse failure (see \a parse)
+
+      Identical to \a parse except that no string is copied. The executable
+      and all values refer directly into \a argv and any default values refer
+      into this instance so both must outlive the returned view.
+   */
+  ParsedOptionsView<Key, Hash> parseView( int argc, char** argv ) const;
+
+  /** \brief Parse the given options with all storage taken from \a resource.
+      \throw std::runtime_error on parse failure (see \a parse)
+
+      Every node, vector and string of the result is allocated from
+      \a resource, so with a std::pmr::monotonic_buffer_resource a whole parse
+      lives in one arena and is released in one step.
+   */
+  pmr::ParsedOptions<Key, Hash> parse( int argc, char** argv, std::pmr::memory_resource* resource ) const;
+
+  /** \brief Parse the given options into an existing result.
+      \throw std::runtime_error on parse failure (see \a parse)
+
+      The previous contents of \a parsed are replaced but its storage is kept,
+      so repeatedly parsing similar command lines into the same instance does
+      not allocate once it has grown to fit. Works for ParsedOptions,
+      ParsedOptionsView and pmr::ParsedOptions alike.
+   */
+  template< class String, class Allocator >
+  void parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed, int argc, char** argv ) const;
+
+  /** \brief Parse the given options, returning an error in the command line
+             rather than throwing it.
+      \throw std::runtime_error only if a response file cannot be read or is
+             invalid, or a subcommand's options cannot be built.
+
+      For untrusted command lines that are often invalid. Rejecting one does
+      not unwind and the ParseError says what and where without allocating,
+      see tryParseArgumentsInto. Use tryParseInto with a reused result to avoid
+      allocating altogether once it has grown to fit.
+   */
+  ParseResult< ParsedOptions<Key, Hash> > tryParse( int argc, char** argv ) const;
+
+  /** \brief As tryParse but into an existing result, see \a parseInto. */
+  template< class String, class Allocator >
+  ParseError tryParseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed, int argc, char** argv ) const;
+
+  /** \brief Parse the whole of the given options, adding every error found to
+             \a diagnostics rather than stopping at the first.
+      \throw std::runtime_error only as tryParse
+      \return True if the command line has no errors
+
+      So that a user can fix a command line in one go. The \a diagnostics are
+      cleared first and, as the records go into storage reserved up front, a
+      command line with any number of errors costs no allocation there. The
+      result in \a parsed is as complete as the errors allow, see
+      ArgvParser::collectErrors.
+   */
+  template< class String, class Allocator >
+  bool diagnose( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+               , ParseDiagnostics<Key>& diagnostics
+               , int argc
+               , char** argv ) const;
+
+  /** \brief Parse the given options, taking any missing from the command line
+             from the config file at \a configPath.
+      \throw std::runtime_error on parse failure (see \a parse) or if the
+             config file cannot be read or is invalid (see mergeConfigFile)
+
+      The file holds name = values settings, where a name is an option's long
+      flag (see ConfigFileReader for the format). Its values are checked
+      against the same minimum and maximum as on the command line. An option
+      on the command line or from the environment replaces the file's setting
+      for it altogether and a setting replaces the option's defaults.
+   */
+  ParsedOptions<Key, Hash> parse( int argc, char** argv, std::string_view configPath ) const;
+
+  /** \brief As parse with a config file but into an existing result, see
+             \a parseInto. A ParsedOptionsView keeps the file mapped.
+   */
+  template< class String, class Allocator >
+  void parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                , int argc
+                , char** argv
+                , std::string_view configPath ) const;
+
+  /** \brief The configuration given on construction. */
+  const Configuration& getConfiguration() const { return config; }
+
+  /** \brief Add subcommand \a name with its own options, built by \a factory
+             only when a parse first reaches the subcommand.
+      \throw std::runtime_error if \a name is empty, starts with - or is
+             already a subcommand.
+
+      On a command line the first positional argument then names the
+      subcommand, the options after it are parsed against its options and the
+      result goes in ParsedOptions::subcommand (see parseArgumentsInto). A
+      subcommand may have subcommands of its own.
+
+      The factory runs at most once however many threads parse at once, if it
+      throws (e.g. on misconfiguration) then so does the parse and the next
+      parse to reach the subcommand tries again. Unlike parsing, adding a
+      subcommand is not safe alongside other calls on this instance.
+   */
+  void addSubcommand( std::string name, std::function< Options() > factory );
+
+  /** \brief Whether any subcommands have been added. */
+  bool hasSubcommands() const { return !subcommands.empty(); }
+
+  /** \brief The options of subcommand \a name, built if need be.
+      \return The options or nullptr if there is no such subcommand.
+      \throw Whatever the subcommand's factory throws.
+   */
+  const Options* findSubcommand( std::string_view name ) const;
+
   /** \brief Look up the definition for the option given by \a key. */
         OptionDefinition& getDefinition( Key key );
   const OptionDefinition& getDefinition( Key key ) const;
 
+  /** \brief A handle for fast repeated lookups of \a key in results parsed by
+             this instance, see ParsedOptions::get.
+      \throw std::runtime_error if there is no option for \a key.
+   */
+  OptionHandle handle( Key key ) const;
+
+  using Definition = KeyedOptionDefinition<Key>;
+
+  /** \brief The number of option definitions. */
+  std::size_t size() const { return availableOptions.size(); }
+
+  /** \brief The position of \a definition, which must be one of ours. */
+  std::size_t slotOf( const Definition& definition ) const { return &definition - availableOptions.data(); }
+
+  /** \brief The definition in \a slot, the inverse of \a slotOf. */
+  const Definition& definitionAt( std::size_t slot ) const { return availableOptions[slot]; }
+
+  /** \brief Look up a definition by flag.
+      \return The definition or nullptr if there is no such flag.
+
+      If abbreviations are allowed by the configuration then \a l may also be
+      the prefix of exactly one long flag.
+   */
+  const Definition* findShort( char s ) const;
+  const Definition* findLong( std::string_view l ) const;
+
+  /** \brief Call \a f with each definition whose long flag starts with
+             \a prefix, in lexicographic order of the long flags.
+   */
+  template< class F >
+  void forEachWithPrefix( std::string_view prefix, F f ) const;
+
+  /** \brief Call \a f with each definition that has default values. */
+  template< class F >
+  void forEachDefault( F f ) const;
+
+  /** \brief Call \a f with ( definition, variable, value ) for each variable
+             in the environment bound to a definition.
+
+      The environment is scanned once, each name being looked up in a perfect
+      hash of the bound names, and not at all if nothing is bound. The views
+      refer into the environment.
+   */
+  template< class F >
+  void forEachFromEnvironment( F f ) const;
+
 private:
   const Configuration config;
 
   using AvailableOptions = std::vector< KeyedOptionDefinition<Key> >;
   const AvailableOptions availableOptions;
 
-  std::unordered_map< Key        , const KeyedOptionDefinition<Key>*, Hash > byKey;
-  std::unordered_map< char       , const KeyedOptionDefinition<Key>*       > byShort;
-  std::unordered_map< std::string, const KeyedOptionDefinition<Key>*       > byLong;
-  std::vector< typename AvailableOptions::const_iterator > haveDefaults;
+  // Short flags index straight into availableOptions, one load per flag even
+  // in a long cluster.
+  using Index = FlagTrie::Index;
+  static constexpr Index None{ FlagTrie::None };
+  std::array< Index, 256 > byShort;
+
+  // Long flags also index into availableOptions.
+  FlagTrie byLong;
+
+  // The remaining indices too are positions in availableOptions rather than
+  // pointers so that a copy or move of this instance is still valid.
+  std::unordered_map< Key, Index, Hash > byKey;
+  // Replaces byKey (and the key hash) for keys with an EnumCount.
+  std::vector< Index > byIndex;
+  std::vector< Index > haveDefaults;
+
+  // Only built if Configuration::usePerfectHash is set. The key hash replaces
+  // byKey, unless two keys have equal hashes, and the long hash takes over the
+  // exact lookups from byLong.
+  MinimalPerfectHash longHash;
+  std::uint64_t longHashSeed{ 0 };
+  MinimalPerfectHash keyHash;
+
+  // Options bound to environment variables, found by name through the
+  // environment hash.
+  struct EnvironmentBinding
+  {
+    std::string variable;
+    Index option;
+  };
+  std::vector< EnvironmentBinding > environmentBindings;
+  MinimalPerfectHash environmentHash;
+  std::uint64_t environmentHashSeed{ 0 };
+
+  // Subcommands by name, each built at most once even with parses racing.
+  // Shared so that a copy of this instance shares the built options.
+  struct Subcommand
+  {
+    std::function< Options() > factory;
+    std::mutex mutex;
+    std::unique_ptr< const Options > options;
+    std::atomic< const Options* > built{ nullptr }; //!< Once options is set
+  };
+  std::map< std::string, std::shared_ptr< Subcommand >, std::less<> > subcommands;
+
+  // The index in availableOptions of \a key, or None.
+  Index findKey( const Key& key ) const;
+
+  // The index in environmentBindings of \a variable, or None.
+  Index findEnvironmentBinding( std::string_view variable ) const;
 };
 
 
 template< class Key, class Hash >
 Options<Key, Hash>::Options( std::initializer_list<KeyedOptionDefinition<Key>> init
                            , Configuration c )
-  : config{ c }
-  , availableOptions{ init }
+  : Options( std::vector<KeyedOptionDefinition<Key>>( init ), std::move( c ) )
 {
-  // Keep track of all short and long options and make sure there are no
-  // duplicates being registered.
-  std::unordered_set<char> shortOptions;
-  std::unordered_set<std::string> longOptions;
+}
+
+
+template< class Key, class Hash >
+Options<Key, Hash>::Options( std::vector<KeyedOptionDefinition<Key>>&& definitions
+                           , Configuration c )
+  : config{ std::move( c ) }
+  , availableOptions{ std::move( definitions ) }
+{
+  if ( availableOptions.size() >= None )
+  {
+    throw std::runtime_error( "Misconfigured options, too many options defined." );
+  }
+  byShort.fill( None );
+
+  // Gather the long options for byLong, which makes sure there are no
+  // duplicates (byShort does the job for short options).
+  std::vector<FlagTrie::Entry> longOptions;
+  longOptions.reserve( availableOptions.size() );
 
   // Keep track of all keys and make sure there are no duplicates
   std::unordered_set<Key, Hash> keys;
+  keys.reserve( availableOptions.size() );
 
-  // Set up the byKey, byShort, and byLong auxiliary maps but do sanity checks first.
+  // Set up byShort and gather the long flags but do sanity checks first.
   for ( auto A = availableOptions.cbegin(); A != availableOptions.cend(); ++A )
   {
     const auto& a{ *A };
@@ -137,28 +486,21 @@ Options<Key, Hash>::Options( std::initializer_list<KeyedOptionDefinition<Key>> i
 
     if ( a.option.s != '\0' )
     {
-      if ( shortOptions.find( a.option.s ) != shortOptions.end() )
+      auto& S{ byShort[ static_cast<unsigned char>( a.option.s ) ] };
+      if ( S != None )
       {
         throw std::runtime_error(
           std::string{ "Misconfigured option, short option " } + a.option.s + " defined twice." );
       }
       else
       {
-        shortOptions.insert( a.option.s );
+        S = static_cast<Index>( A - availableOptions.cbegin() );
       }
     }
 
     if ( !a.option.l.empty() )
     {
-      if ( longOptions.find( a.option.l ) != longOptions.end() )
-      {
-        throw std::runtime_error(
-          std::string{ "Misconfigured option, long option " } + a.option.l + " defined twice." );
-      }
-      else
-      {
-        longOptions.insert( a.option.l );
-      }
+      longOptions.push_back( { a.option.l, static_cast<Index>( A - availableOptions.cbegin() ) } );
     }
 
     const auto K{ keys.find( a.key ) };
@@ -170,6 +512,16 @@ Options<Key, Hash>::Options( std::initializer_list<KeyedOptionDefinition<Key>> i
     }
     keys.emplace( a.key );
 
+    if constexpr ( hasEnumCount<Key> )
+    {
+      if ( enumIndex( a.key ) >= EnumCount<Key>::value )
+      {
+        throw std::runtime_error(
+          std::string{ "Misconfigured option, key outside EnumCount for " }
+                     + ( a.option.s == '\0' ? a.option.l : std::string{ a.option.s } ) );
+      }
+    }
+
     if ( ( a.option.minNumValues > -1 )
       && ( a.option.maxNumValues > -1 )
       && ( a.option.minNumValues > a.option.maxNumValues ) )
@@ -194,183 +546,360 @@ Options<Key, Hash>::Options( std::initializer_list<KeyedOptionDefinition<Key>> i
                      + ( a.option.s == '\0' ? a.option.l : std::string{ a.option.s } ) );
       }
 
-      haveDefaults.emplace_back( A );
+      haveDefaults.push_back( static_cast<Index>( A - availableOptions.cbegin() ) );
     }
 
-    byKey  [ a.key      ] = &a;
-    byShort[ a.option.s ] = &a;
-    byLong [ a.option.l ] = &a;
+  }
+
+  if ( config.usePerfectHash )
+  {
+    std::vector<std::uint64_t> hashes;
+    hashes.reserve( availableOptions.size() );
+    if constexpr ( !hasEnumCount<Key> )
+    {
+      for ( const auto& a : availableOptions )
+      {
+        hashes.push_back( Hash{}( a.key ) );
+      }
+      keyHash.build( hashes );
+    }
+
+    // The long flags are all distinct so only a very unlucky seed can fail.
+    std::vector<Index> values;
+    values.reserve( longOptions.size() );
+    for ( const auto& l : longOptions )
+    {
+      values.push_back( l.value );
+    }
+    do
+    {
+      ++longHashSeed;
+      hashes.clear();
+      for ( const auto& l : longOptions )
+      {
+        hashes.push_back( hashString( l.flag, longHashSeed ) );
+      }
+    } while ( !longHash.build( hashes, values ) && ( longHashSeed < 16 ) );
+  }
+
+  if constexpr ( hasEnumCount<Key> )
+  {
+    byIndex.assign( EnumCount<Key>::value, None );
+    for ( const auto& a : availableOptions )
+    {
+      byIndex[ enumIndex( a.key ) ] = static_cast<Index>( &a - availableOptions.data() );
+    }
+  }
+  // Fall back on a map if the keys could not be perfectly hashed.
+  else if ( keyHash.empty() )
+  {
+    byKey.reserve( availableOptions.size() );
+    for ( const auto& a : availableOptions )
+    {
+      byKey[ a.key ] = static_cast<Index>( &a - availableOptions.data() );
+    }
+  }
+
+  byLong = FlagTrie{ std::move( longOptions ) };
+
+  std::unordered_set<std::string> variables;
+  for ( const auto& a : availableOptions )
+  {
+    std::string variable{ boundEnvironmentVariable( config.environmentPrefix, a.option ) };
+    if ( variable.empty() )
+    {
+      continue;
+    }
+    if ( !variables.insert( variable ).second )
+    {
+      throw std::runtime_error(
+        std::string{ "Misconfigured option, environment variable " } + variable + " bound twice." );
+    }
+    environmentBindings.push_back( { std::move( variable ), static_cast<Index>( &a - availableOptions.data() ) } );
+  }
+
+  if ( !environmentBindings.empty() )
+  {
+    std::vector<std::uint64_t> hashes;
+    hashes.reserve( environmentBindings.size() );
+    do
+    {
+      ++environmentHashSeed;
+      hashes.clear();
+      for ( const auto& binding : environmentBindings )
+      {
+        hashes.push_back( hashString( binding.variable, environmentHashSeed ) );
+      }
+    } while ( !environmentHash.build( hashes ) && ( environmentHashSeed < 16 ) );
   }
 }
 
 
-template< class Key >
-struct Parsing
+template< class Key, class Hash >
+ParsedOptions<Key, Hash> Options<Key, Hash>::parse( int argc, char** argv ) const
 {
-  Parsing( const KeyedOptionDefinition<Key>& o
-         , const std::string& invocationFlag
-         , ParsedOption& p )
-    : option{ o }, invocationFlag{ invocationFlag }, parsedOption{ p } {}
-
-  const KeyedOptionDefinition<Key>& option;
-  const std::string invocationFlag;
-  ParsedOption& parsedOption;
-};
+  return parseArgv<ParsedOptions<Key, Hash>>( *this, config, argc, argv );
+}
 
 
 template< class Key, class Hash >
-ParsedOptions<Key, Hash> Options<Key, Hash>::parse( int argc, char** argv ) const
+template< class Handler, class >
+void Options<Key, Hash>::parse( int argc, char** argv, Handler& handler ) const
+{
+  parseEvents( *this, config, argv, argv + argc, handler );
+}
+
+
+template< class Key, class Hash >
+ParsedOptionsView<Key, Hash> Options<Key, Hash>::parseView( int argc, char** argv ) const
+{
+  return parseArgv<ParsedOptionsView<Key, Hash>>( *this, config, argc, argv );
+}
+
+
+template< class Key, class Hash >
+pmr::ParsedOptions<Key, Hash> Options<Key, Hash>::parse( int argc
+                                                      , char** argv
+                                                      , std::pmr::memory_resource* resource ) const
+{
+  return parseArgv<pmr::ParsedOptions<Key, Hash>>( *this, config, argc, argv, resource );
+}
+
+
+template< class Key, class Hash >
+template< class String, class Allocator >
+void Options<Key, Hash>::parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                                  , int argc
+                                  , char** argv ) const
 {
-  ParsedOptions<Key, Hash> parsed{ argv[0] };
+  parseArgvInto( *this, config, argc, argv, parsed );
+}
 
-  parsed.optionsByKey.reserve( availableOptions.size() );
-  parsed.optionsByArgvPosition.reserve( argc );
 
-  // Note that we don't yet support option values that start with a dash. We
-  // possibly could in cases where there are an exact number of expected
-  // arguments but that's for future if it is ever required.
-  std::optional<Parsing<Key>> currentlyParsing;
+template< class Key, class Hash >
+ParseResult< ParsedOptions<Key, Hash> > Options<Key, Hash>::tryParse( int argc, char** argv ) const
+{
+  ParsedOptions<Key, Hash> parsed;
+  const ParseError error{ tryParseInto( parsed, argc, argv ) };
+  return { std::move( parsed ), error };
+}
+
 
-  std::vector< std::string > trailingValues;
+template< class Key, class Hash >
+template< class String, class Allocator >
+ParseError Options<Key, Hash>::tryParseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                                           , int argc
+                                           , char** argv ) const
+{
+  return tryParseArgumentsInto( *this, config, argv, argv + argc, parsed );
+}
+
+
+template< class Key, class Hash >
+template< class String, class Allocator >
+bool Options<Key, Hash>::diagnose( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                                 , ParseDiagnostics<Key>& diagnostics
+                                 , int argc
+                                 , char** argv ) const
+{
+  diagnostics.clear();
+  tryParseArgumentsInto( *this, config, argv, argv + argc, parsed, {}, &diagnostics );
+  return diagnostics.empty();
+}
 
-  for ( int i = 1; i < argc; ++i )
+
+template< class Key, class Hash >
+ParsedOptions<Key, Hash> Options<Key, Hash>::parse( int argc, char** argv, std::string_view configPath ) const
+{
+  ParsedOptions<Key, Hash> parsed;
+  parseInto( parsed, argc, argv, configPath );
+  return parsed;
+}
+
+
+template< class Key, class Hash >
+template< class String, class Allocator >
+void Options<Key, Hash>::parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                                  , int argc
+                                  , char** argv
+                                  , std::string_view configPath ) const
+{
+  parseArgumentsInto( *this, config, argv, argv + argc, parsed, configPath );
+}
+
+
+template< class Key, class Hash >
+void Options<Key, Hash>::addSubcommand( std::string name, std::function< Options() > factory )
+{
+  if ( name.empty() || ( name[0] == '-' ) )
+  {
+    throw std::runtime_error( "Misconfigured subcommand, name empty or starting with -." );
+  }
+  auto subcommand{ std::make_shared<Subcommand>() };
+  subcommand->factory = std::move( factory );
+  if ( !subcommands.emplace( name, std::move( subcommand ) ).second )
   {
-    std::string s{ argv[i] }; // non-const as it will be moved if it's not a flag
+    throw std::runtime_error( std::string{ "Misconfigured subcommand, " } + name + " defined twice." );
+  }
+}
+
+
+template< class Key, class Hash >
+auto Options<Key, Hash>::findSubcommand( std::string_view name ) const -> const Options*
+{
+  const auto S{ subcommands.find( name ) };
+  if ( S == subcommands.cend() )
+  {
+    return nullptr;
+  }
+
+  auto& subcommand{ *S->second };
+  if ( const Options* const built{ subcommand.built.load( std::memory_order_acquire ) } )
+  {
+    return built;
+  }
+
+  // Not std::call_once, which can deadlock after the factory throws.
+  const std::lock_guard<std::mutex> lock{ subcommand.mutex };
+  if ( !subcommand.options )
+  {
+    subcommand.options = std::make_unique<const Options>( subcommand.factory() );
+    subcommand.built.store( subcommand.options.get(), std::memory_order_release );
+  }
+  return subcommand.options.get();
+}
 
-    if ( s[0] == '-' )
-    {
-      // Got a flag, is it short or long?
-      if ( ( s.size() > 1 ) && ( s[1] == '-' ) )
-      {
-        // Long flag
-        const auto L{ byLong.find( s.substr( 2 ) ) };
-        if ( L == byLong.end() )
-        {
-          throw std::runtime_error{ std::string{ "Unknown long option " } + s.substr( 2 ) };
-        }
-        // Close off the flag we are currently parsing, if any
-        if ( currentlyParsing )
-        {
-          if ( currentlyParsing->parsedOption.occurrences.back().values.size()
-               < currentlyParsing->option.option.minNumValues )
-          {
-            throw std::runtime_error{ std::string{ "Too few values for option " }
-                                    + currentlyParsing->invocationFlag };
-          }
-          if ( !trailingValues.empty() )
-          {
-            throw std::runtime_error{ std::string{ "Too many values for option " }
-                                    + currentlyParsing->invocationFlag };
-          }
-        }
-        const KeyedOptionDefinition<Key>& option{ *L->second };
-        // Add or reuse parsed map entry as required
-        currentlyParsing.emplace( option, s.substr( 2 ), parsed.optionsByKey[ option.key ] );
-        parsed.optionsByArgvPosition.emplace_back( i, option.key, currentlyParsing->parsedOption.occurrences.size() );
-        currentlyParsing->parsedOption.occurrences.emplace_back();
-      }
-      else // short flag, could be multiple short options all together
-      {
-        for ( std::string::size_type j = 1; j < s.size(); ++j )
-        {
-          const auto S{ byShort.find( s[j] ) };
-          if ( S == byShort.end() )
-          {
-            throw std::runtime_error{ std::string{ "Unknown short option " } + s[j] };
-          }
-          // Close off the flag we are currently parsing, if any
-          if ( currentlyParsing )
-          {
-            if ( currentlyParsing->parsedOption.occurrences.back().values.size()
-                 < currentlyParsing->option.option.minNumValues )
-            {
-              throw std::runtime_error{ std::string{ "Too few values for option " }
-                                      + currentlyParsing->invocationFlag };
-            }
-            if ( !trailingValues.empty() )
-            {
-              throw std::runtime_error{ std::string{ "Too many values for option " }
-                                      + currentlyParsing->invocationFlag };
-            }
-          }
-          const KeyedOptionDefinition<Key>& option{ *S->second };
-          // Add or reuse parsed map entry as required
-          currentlyParsing.emplace( option, &s[j], parsed.optionsByKey[ option.key ] );
-          parsed.optionsByArgvPosition.emplace_back( i, option.key, currentlyParsing->parsedOption.occurrences.size() );
-          currentlyParsing->parsedOption.occurrences.emplace_back();
-        }
-      }
 
-      trailingValues.clear();
+template< class Key, class Hash >
+const KeyedOptionDefinition<Key>* Options<Key, Hash>::findShort( char s ) const
+{
+  const Index S{ byShort[ static_cast<unsigned char>( s ) ] };
+  return S == None ? nullptr : &availableOptions[S];
+}
+
+
+template< class Key, class Hash >
+const KeyedOptionDefinition<Key>* Options<Key, Hash>::findLong( std::string_view l ) const
+{
+  if ( !longHash.empty() )
+  {
+    const Index L{ longHash.find( hashString( l, longHashSeed ) ) };
+    if ( availableOptions[L].option.l == l )
+    {
+      return &availableOptions[L];
     }
-    else // not a flag
+    if ( !config.allowAbbreviations )
     {
-      if ( currentlyParsing )
-      {
-        auto& occurrence{ currentlyParsing->parsedOption.occurrences.back() };
-
-        // Current policy is to treat excess values as an error unless they are
-        // trailing but we don't know if they are trailing values until we've
-        // finished looking for flags. So keep a note of them and if we hit
-        // another flag then we throw and if not we file them under the trailing
-        // values enumeration.
-        if ( occurrence.values.size() == currentlyParsing->option.option.maxNumValues )
-        {
-          trailingValues.emplace_back( std::move( s ) );
-        }
-        else
-        {
-          occurrence.values.emplace_back( std::move( s ) );
-        }
-      }
-      else
-      {
-        trailingValues.emplace_back( std::move( s ) );
-      }
+      return nullptr;
     }
   }
 
-  // Close off the flag we are currently parsing, if any
-  if ( currentlyParsing )
+  const Index L{ config.allowAbbreviations ? byLong.findUnambiguous( l ) : byLong.find( l ) };
+  return L == None ? nullptr : &availableOptions[L];
+}
+
+
+template< class Key, class Hash >
+template< class F >
+void Options<Key, Hash>::forEachWithPrefix( std::string_view prefix, F f ) const
+{
+  byLong.forEachWithPrefix( prefix, [this, &f]( FlagTrie::Index i ) { f( availableOptions[i] ); } );
+}
+
+
+template< class Key, class Hash >
+template< class F >
+void Options<Key, Hash>::forEachDefault( F f ) const
+{
+  for ( const Index D : haveDefaults )
+  {
+    f( availableOptions[D] );
+  }
+}
+
+
+template< class Key, class Hash >
+template< class F >
+void Options<Key, Hash>::forEachFromEnvironment( F f ) const
+{
+  if ( environmentBindings.empty() )
   {
-    if ( currentlyParsing->parsedOption.occurrences.back().values.size()
-         < currentlyParsing->option.option.minNumValues )
+    return;
+  }
+
+  forEachEnvironmentVariable( [this, &f]( std::string_view variable, std::string_view value )
+  {
+    const Index B{ findEnvironmentBinding( variable ) };
+    if ( B != None )
     {
-      throw std::runtime_error{ std::string{ "Too few values for option " }
-                              + currentlyParsing->invocationFlag };
+      f( availableOptions[ environmentBindings[B].option ], variable, value );
     }
-    // Only check for excess values here if we are not accepting trailing values.
-    if ( !config.allowTrailingValues && !trailingValues.empty() )
+  } );
+}
+
+
+template< class Key, class Hash >
+auto Options<Key, Hash>::findEnvironmentBinding( std::string_view variable ) const -> Index
+{
+  if ( !environmentHash.empty() )
+  {
+    const Index B{ environmentHash.find( hashString( variable, environmentHashSeed ) ) };
+    return environmentBindings[B].variable == variable ? B : None;
+  }
+
+  // Only if no seed gave a perfect hash, which takes very bad luck.
+  for ( std::size_t b = 0; b < environmentBindings.size(); ++b )
+  {
+    if ( environmentBindings[b].variable == variable )
     {
-      throw std::runtime_error{ std::string{ "Too many values for option " }
-                              + currentlyParsing->invocationFlag };
+      return static_cast<Index>( b );
     }
   }
+  return None;
+}
 
-  if ( config.allowTrailingValues && !trailingValues.empty() )
+
+template< class Key, class Hash >
+auto Options<Key, Hash>::findKey( const Key& key ) const -> Index
+{
+  if constexpr ( hasEnumCount<Key> )
   {
-    parsed.trailingValues = std::move( trailingValues );
+    const auto i{ enumIndex( key ) };
+    return i < byIndex.size() ? byIndex[i] : None;
   }
 
-  // Add in missing options that have defaults
-  for ( auto A : haveDefaults )
+  if ( !keyHash.empty() )
   {
-    if ( parsed.optionsByKey.find( A->key ) == parsed.optionsByKey.end() )
-    {
-      parsed.optionsByKey[ A->key ].occurrences.emplace_back().values = A->option.defaultValues;
-    }
+    const Index K{ keyHash.find( Hash{}( key ) ) };
+    return availableOptions[K].key == key ? K : None;
   }
 
-  return parsed;
+  const auto I{ byKey.find( key ) };
+  if ( I != byKey.cend() )
+  {
+    return I->second;
+  }
+  return None;
+}
+
+template< class Key, class Hash >
+OptionHandle Options<Key, Hash>::handle( Key key ) const
+{
+  const Index K{ findKey( key ) };
+  if ( K != None )
+  {
+    return { K };
+  }
+  throw std::runtime_error( "Option key not found" );
 }
 
 template< class Key, class Hash >
 OptionDefinition& Options<Key, Hash>::getDefinition( Key key )
 {
-  const auto I{ byKey.find( key ) };
-  if ( I != byKey.end() )
+  const Index K{ findKey( key ) };
+  if ( K != None )
   {
-    return I->second->option;
+    return availableOptions[K].option;
   }
   throw std::runtime_error( "Option key not found" );
 }
@@ -378,10 +907,10 @@ OptionDefinition& Options<Key, Hash>::getDefinition( Key key )
 template< class Key, class Hash >
 const OptionDefinition& Options<Key, Hash>::getDefinition( Key key ) const
 {
-  const auto I{ byKey.find( key ) };
-  if ( I != byKey.cend() )
+  const Index K{ findKey( key ) };
+  if ( K != None )
   {
-    return I->second->option;
+    return availableOptions[K].option;
   }
   throw std::runtime_error( "Option key not found" );
 }
@@ -0,0 +1,168 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_OPTIONSPARSER_H
+#define LIB_LB_OPTIONS_OPTIONSPARSER_H
+
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include <lb/options/Options.h>
+#include <lb/options/ParsedOptions.h>
+#include <lb/options/Parsing.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief A parse session fed one argument at a time.
+
+    Use this instead of Options::parse when the arguments are not all to hand
+    up front, e.g. they arrive over a pipe. Each argument is checked as it is
+    fed, so an unknown flag or an option short of values is reported
+    straight away, and only the result itself is kept. The min/max,
+    trailing value and default rules for the end of the command line are
+    applied by finish().
+
+    Arguments are copied into the result so they need only be valid for the
+    call to feed. A response file argument is expanded if the Options
+    configuration asks for it.
+
+    Once finished, reset starts a new session that reuses the result's storage
+    (as Options::parseInto does).
+ */
+template< class Key, class Hash = std::hash<Key> >
+class OptionsParser
+{
+public:
+  /** \brief Start a session parsing against \a options, which must outlive it. */
+  explicit OptionsParser( const Options<Key, Hash>& options, std::string_view executable = {} );
+
+  // The parser refers to the result within this instance.
+  OptionsParser( const OptionsParser& ) = delete;
+  OptionsParser& operator=( const OptionsParser& ) = delete;
+
+  /** \brief Process the next argument.
+      \throw std::runtime_error on parse failure (see Options::parse) or if the
+             session has finished. The session cannot continue after a failure.
+   */
+  void feed( std::string_view argument );
+
+  /** \brief End the session.
+      \throw std::runtime_error on parse failure (see Options::parse) or if the
+             session has already finished.
+      \return The result, which stays valid until reset or destruction.
+   */
+  ParsedOptions<Key, Hash>& finish();
+
+  /** \brief Start a new session, discarding the current one, if any. */
+  void reset( std::string_view executable = {} );
+
+  /** \brief The result so far, complete only once finished. */
+  const ParsedOptions<Key, Hash>& getParsed() const { return parsed; }
+
+  /** \brief The number of arguments fed this session, after expansion of any
+             response files.
+   */
+  std::size_t getNumFed() const { return parser ? parser->getPosition() : numFed; }
+
+private:
+  using Parser = ArgvParser< Options<Key, Hash>, ParsedOptions<Key, Hash> >;
+
+  const Options<Key, Hash>& options;
+  ParsedOptions<Key, Hash> parsed;
+  std::optional< Parser > parser; //!< Empty once finished
+  std::size_t numFed{ 0 };        //!< As of finishing
+};
+
+
+template< class Key, class Hash >
+OptionsParser<Key, Hash>::OptionsParser( const Options<Key, Hash>& o, std::string_view executable )
+  : options{ o }
+{
+  reset( executable );
+}
+
+
+template< class Key, class Hash >
+void OptionsParser<Key, Hash>::feed( std::string_view argument )
+{
+  if ( !parser )
+  {
+    throw std::runtime_error( "Options parser fed after finishing" );
+  }
+
+  if ( options.getConfiguration().expandResponseFiles && ( argument.size() > 1 ) && ( argument[0] == '@' ) )
+  {
+    feedResponseFile( *parser, parsed, argument.substr( 1 ), 1 );
+  }
+  else
+  {
+    parser->feed( argument );
+  }
+}
+
+
+template< class Key, class Hash >
+ParsedOptions<Key, Hash>& OptionsParser<Key, Hash>::finish()
+{
+  if ( !parser )
+  {
+    throw std::runtime_error( "Options parser already finished" );
+  }
+
+  numFed = parser->getPosition();
+  parser->finish();
+  parser.reset();
+  return parsed;
+}
+
+
+template< class Key, class Hash >
+void OptionsParser<Key, Hash>::reset( std::string_view executable )
+{
+  parser.reset();
+  parsed.clear();
+  parsed.executable = executable;
+  parser.emplace( options, options.getConfiguration().allowTrailingValues, parsed );
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_OPTIONSPARSER_H
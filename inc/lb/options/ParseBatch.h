@@ -0,0 +1,254 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_PARSEBATCH_H
+#define LIB_LB_OPTIONS_PARSEBATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <lb/options/Options.h>
+#include <lb/options/ParsedOptions.h>
+#include <lb/options/Parsing.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief The most command lines a worker claims at once in a batch parse. */
+constexpr std::size_t MaxBatchChunk{ 256 };
+
+
+/** \brief Parse many command lines against one Options instance in parallel.
+    \throw Whatever \a f or \a executor throws, after the other workers have
+           stopped
+
+    \a lines is indexable with operator[] and has a std::size. Each line is a
+    range laid out as argv is, the executable then the arguments, whose
+    elements convert to std::string_view, e.g. std::vector<std::string> or
+    std::vector<const char*>.
+
+    For every line \a f is called as f( index, parsed, error ) with exactly
+    one of parsed (const ParsedOptions<Key, Hash>*) and error
+    (const std::runtime_error*) set. Both are only valid for the call. Lines
+    are handed out in order within a worker but workers run concurrently, so
+    \a f must be safe to call from several threads at once.
+
+    The calling thread works through the lines itself and \a executor, called
+    with a std::function<void()>, is given up to \a numTasks - 1 more workers
+    to run, e.g. on a ThreadPool. Workers claim chunks of lines from a shared
+    counter so one that lands on slow lines does not hold up the rest. Each
+    worker parses into a single ParsedOptions of its own, see
+    Options::parseInto, so it stops allocating once that has grown to fit.
+    Nothing waits for workers that \a executor has not started by the time the
+    calling thread runs out of lines, so calling this from a task on the same
+    pool cannot deadlock.
+ */
+template< class Key, class Hash, class Lines, class F, class Executor >
+void forEachParsed( const Options<Key, Hash>& options
+                  , const Lines& lines
+                  , F&& f
+                  , Executor&& executor
+                  , std::size_t numTasks = std::thread::hardware_concurrency() )
+{
+  using std::size;
+  const std::size_t NumLines{ size( lines ) };
+  if ( NumLines == 0 )
+  {
+    return;
+  }
+  numTasks = std::clamp<std::size_t>( numTasks, 1, NumLines );
+  const std::size_t ChunkSize{ std::clamp<std::size_t>( NumLines / ( numTasks * 8 ), 1, MaxBatchChunk ) };
+
+  // Shared with the workers so that one started late can find out that the
+  // batch is over without touching anything else.
+  struct State
+  {
+    std::atomic<std::size_t> next{ 0 };
+    std::atomic<bool> failed{ false };
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::size_t numActive{ 0 };
+    bool closed{ false };
+    std::exception_ptr exception;
+  };
+  const auto state{ std::make_shared<State>() };
+
+  const auto work = [ & ]( State& s )
+  {
+    ParsedOptions<Key, Hash> parsed;
+    try
+    {
+      for ( std::size_t first{ s.next.fetch_add( ChunkSize, std::memory_order_relaxed ) }
+          ; ( first < NumLines ) && !s.failed.load( std::memory_order_relaxed )
+          ; first = s.next.fetch_add( ChunkSize, std::memory_order_relaxed ) )
+      {
+        const std::size_t Last{ std::min( first + ChunkSize, NumLines ) };
+        for ( std::size_t i = first; i < Last; ++i )
+        {
+          const auto& line{ lines[i] };
+          try
+          {
+            parseArgumentsInto( options, options.getConfiguration(), std::begin( line ), std::end( line ), parsed );
+          }
+          catch ( const std::runtime_error& e )
+          {
+            f( i, static_cast< const ParsedOptions<Key, Hash>* >( nullptr ), &e );
+            continue;
+          }
+          f( i, &parsed, static_cast<const std::runtime_error*>( nullptr ) );
+        }
+      }
+    }
+    catch ( ... )
+    {
+      s.failed = true;
+      std::lock_guard<std::mutex> lock{ s.mutex };
+      if ( !s.exception )
+      {
+        s.exception = std::current_exception();
+      }
+    }
+  };
+
+  // Tasks already handed to executor refer to work so, however the
+  // submission below ends, none may still be running once this returns.
+  const auto close = [ &state ]
+  {
+    std::unique_lock<std::mutex> lock{ state->mutex };
+    state->closed = true;
+    state->idle.wait( lock, [ &state ]{ return state->numActive == 0; } );
+  };
+
+  try
+  {
+    for ( std::size_t i = 1; i < numTasks; ++i )
+    {
+      executor( std::function<void()>{ [ state, &work ]
+      {
+        {
+          std::lock_guard<std::mutex> lock{ state->mutex };
+          if ( state->closed )
+          {
+            return;
+          }
+          ++state->numActive;
+        }
+        work( *state );
+        std::lock_guard<std::mutex> lock{ state->mutex };
+        if ( --state->numActive == 0 )
+        {
+          state->idle.notify_all();
+        }
+      } } );
+    }
+  }
+  catch ( ... )
+  {
+    state->failed = true;
+    close();
+    throw;
+  }
+
+  // Catches everything itself.
+  work( *state );
+
+  close();
+  if ( state->exception )
+  {
+    std::rethrow_exception( state->exception );
+  }
+}
+
+
+/** \brief The outcome of parsing one command line of a batch. */
+template< class Key, class Hash = std::hash<Key> >
+struct BatchResult
+{
+  std::optional< ParsedOptions<Key, Hash> > parsed; //!< Set on success
+  std::string error;                                //!< The reason on failure
+};
+
+
+/** \brief Parse many command lines against one Options instance in parallel.
+    \return One result per line, in the order of \a lines.
+
+    See forEachParsed for \a lines, \a executor and \a numTasks. Each result
+    is copied out of the worker's scratch ParsedOptions, use forEachParsed
+    directly to inspect the results in place without that.
+ */
+template< class Key, class Hash, class Lines, class Executor >
+std::vector< BatchResult<Key, Hash> > parseBatch( const Options<Key, Hash>& options
+                                                , const Lines& lines
+                                                , Executor&& executor
+                                                , std::size_t numTasks = std::thread::hardware_concurrency() )
+{
+  using std::size;
+  std::vector< BatchResult<Key, Hash> > results( size( lines ) );
+  forEachParsed( options
+               , lines
+               , [ &results ]( std::size_t i, const ParsedOptions<Key, Hash>* parsed, const std::runtime_error* error )
+                 {
+                   if ( parsed )
+                   {
+                     results[i].parsed.emplace( *parsed );
+                   }
+                   else
+                   {
+                     results[i].error = error->what();
+                   }
+                 }
+               , std::forward<Executor>( executor )
+               , numTasks );
+  return results;
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_PARSEBATCH_H
@@ -0,0 +1,381 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_PARSECACHE_H
+#define LIB_LB_OPTIONS_PARSECACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <lb/options/Options.h>
+#include <lb/options/ParsedOptions.h>
+#include <lb/options/Parsing.h>
+#include <lb/options/PerfectHash.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief Remembers the last few command lines parsed against an Options
+           instance and their results.
+
+    Meant for a stream of near identical command lines, e.g. a REPL or daemon.
+    Each argument is hashed into a rolling hash of the command line so far.
+    A command line identical to a cached one returns that result with no
+    parsing at all. Otherwise the cached command line sharing the longest
+    prefix is rolled back to the end of that prefix and the parse carries on
+    from the first argument that differs, the new command line taking over
+    that entry. What the environment and defaults added is kept unless the
+    new arguments replace it. Only if nothing shares an argument is it parsed
+    from scratch, into the least recently used entry.
+
+    A result is only valid until the next call to parse and reflects the
+    environment as it was when first parsed, call clear() if that changes.
+    Command lines with response files (see
+    Options::Configuration::expandResponseFiles) are never cached as the files
+    may change, nor are any for Options with subcommands.
+
+    A cache is not safe to use from several threads at once, unlike the
+    Options it parses against.
+ */
+template< class Key, class Hash = std::hash<Key> >
+class ParseCache
+{
+public:
+  /** \brief How parses have been served. */
+  struct Statistics
+  {
+    std::size_t hits{ 0 };    //!< Identical to a cached command line
+    std::size_t resumes{ 0 }; //!< Carried on from a cached prefix
+    std::size_t misses{ 0 };  //!< Parsed from scratch
+  };
+
+  /** \brief Cache up to \a capacity (at least one) command lines parsed
+             against \a options, which must outlive this.
+   */
+  explicit ParseCache( const Options<Key, Hash>& options, std::size_t capacity = 8 )
+    : options{ options }, entries( std::max<std::size_t>( capacity, 1 ) ) {}
+
+  /** \brief Parse as Options::parse does, reusing what is cached where possible.
+      \throw std::runtime_error on parse failure (see Options::parse)
+   */
+  const ParsedOptions<Key, Hash>& parse( int argc, char** argv );
+
+  /** \brief Forget every cached command line. */
+  void clear();
+
+  const Statistics& getStatistics() const { return statistics; }
+
+private:
+  using Parsed = ParsedOptions<Key, Hash>;
+  using Parser = ArgvParser<Options<Key, Hash>, Parsed>;
+
+  struct Entry
+  {
+    std::vector<std::string> arguments;        //!< Including the executable
+    std::vector<std::uint64_t> prefixHashes;   //!< Of arguments [0, i]
+    std::vector<bool> fromFinish;              //!< By slot, added by the environment or defaults
+    Parsed parsed;
+    std::uint64_t lastUsed{ 0 };
+    bool valid{ false };
+  };
+
+  // The number of leading arguments of \a entry that are the same as argv.
+  std::size_t commonPrefix( const Entry& entry, std::size_t argc, char** argv ) const;
+
+  // Parse argv into \a entry, carrying on from its first \a length arguments
+  // if that is at least one.
+  const Parsed& parseInto( Entry& entry, std::size_t length, std::size_t argc, char** argv, bool cacheable );
+
+  // Take \a entry back to how it was after its first \a length arguments,
+  // bar what the environment and defaults added, and set \a parser to carry on
+  // from there. Returns the number of options started that are left.
+  std::size_t rollBack( Entry& entry, std::size_t length, Parser& parser ) const;
+
+  const Options<Key, Hash>& options;
+  std::vector<Entry> entries;
+  std::vector<std::uint64_t> hashes; //!< Prefix hashes of the argv being parsed
+  std::uint64_t clock{ 0 };
+  Statistics statistics;
+};
+
+
+template< class Key, class Hash >
+auto ParseCache<Key, Hash>::parse( int argc, char** argv ) -> const Parsed&
+{
+  const std::size_t N{ static_cast<std::size_t>( std::max( argc, 0 ) ) };
+  if ( N == 0 )
+  {
+    throw std::runtime_error{ "Empty command line, expected at least the executable" };
+  }
+
+  // Where the options change mid line a rollback cannot tell which apply.
+  if ( options.hasSubcommands() )
+  {
+    ++statistics.misses;
+    auto& entry{ entries.front() };
+    entry.valid = false;
+    options.parseInto( entry.parsed, argc, argv );
+    return entry.parsed;
+  }
+
+  hashes.resize( N );
+  std::uint64_t h{ 0 };
+  bool hasResponseFile{ false };
+  for ( std::size_t i = 0; i < N; ++i )
+  {
+    const std::string_view argument{ argv[i] };
+    h = mixHash( h ^ std::hash<std::string_view>{}( argument ) );
+    hashes[i] = h;
+    hasResponseFile = hasResponseFile || ( ( i > 0 ) && ( argument.size() > 1 ) && ( argument[0] == '@' ) );
+  }
+  ++clock;
+
+  const bool Cacheable{ !( options.getConfiguration().expandResponseFiles && hasResponseFile ) };
+  Entry* best{ nullptr };
+  std::size_t bestLength{ 0 };
+  if ( Cacheable )
+  {
+    for ( auto& entry : entries )
+    {
+      if ( !entry.valid )
+      {
+        continue;
+      }
+      const std::size_t Length{ commonPrefix( entry, N, argv ) };
+      if ( ( Length == N ) && ( entry.arguments.size() == N ) )
+      {
+        ++statistics.hits;
+        entry.lastUsed = clock;
+        return entry.parsed;
+      }
+      if ( Length > bestLength )
+      {
+        best = &entry;
+        bestLength = Length;
+      }
+    }
+  }
+
+  // Only worth it if an argument beyond the executable is shared.
+  if ( best && ( bestLength > 1 ) )
+  {
+    ++statistics.resumes;
+    return parseInto( *best, bestLength, N, argv, Cacheable );
+  }
+
+  ++statistics.misses;
+  const auto LeastRecent{ std::min_element( entries.begin(), entries.end(), []( const Entry& a, const Entry& b )
+  {
+    return ( a.valid ? a.lastUsed : 0 ) < ( b.valid ? b.lastUsed : 0 );
+  } ) };
+  return parseInto( *LeastRecent, 0, N, argv, Cacheable );
+}
+
+
+template< class Key, class Hash >
+void ParseCache<Key, Hash>::clear()
+{
+  for ( auto& entry : entries )
+  {
+    entry.valid = false;
+  }
+}
+
+
+template< class Key, class Hash >
+std::size_t ParseCache<Key, Hash>::commonPrefix( const Entry& entry, std::size_t argc, char** argv ) const
+{
+  const std::size_t Limit{ std::min( entry.arguments.size(), argc ) };
+  std::size_t length{ 0 };
+  while ( ( length < Limit ) && ( entry.prefixHashes[length] == hashes[length] ) )
+  {
+    ++length;
+  }
+
+  // The hashes could collide so make sure.
+  for ( std::size_t i = 0; i < length; ++i )
+  {
+    if ( entry.arguments[i] != argv[i] )
+    {
+      return i;
+    }
+  }
+  return length;
+}
+
+
+template< class Key, class Hash >
+auto ParseCache<Key, Hash>::parseInto( Entry& entry
+                                     , std::size_t length
+                                     , std::size_t argc
+                                     , char** argv
+                                     , bool cacheable ) -> const Parsed&
+{
+  // Half parsed if anything throws.
+  entry.valid = false;
+
+  const auto& config{ options.getConfiguration() };
+  auto& parsed{ entry.parsed };
+  if ( length == 0 )
+  {
+    parsed.clear();
+    parsed.executable = argv[0];
+    entry.fromFinish.assign( options.size(), false );
+  }
+  Parser parser{ options, config.allowTrailingValues, parsed };
+  const std::size_t NumKept{ length > 0 ? rollBack( entry, length, parser ) : 0 };
+
+  for ( std::size_t i = std::max<std::size_t>( length, 1 ); i < argc; ++i )
+  {
+    const std::string_view argument{ argv[i] };
+    if ( config.expandResponseFiles && ( argument.size() > 1 ) && ( argument[0] == '@' ) )
+    {
+      feedResponseFile( parser, parsed, argument.substr( 1 ), 1 );
+    }
+    else
+    {
+      parser.feed( argument );
+    }
+  }
+  parser.finishArguments();
+
+  // An option the environment or defaults added last time that is now on the
+  // command line loses the occurrence they gave it.
+  auto& started{ parsed.optionsByArgvPosition };
+  for ( std::size_t i = NumKept; i < started.size(); ++i )
+  {
+    const Key K{ started[i].key };
+    const std::size_t Slot{ options.handle( K ).slot };
+    if ( entry.fromFinish[Slot] )
+    {
+      entry.fromFinish[Slot] = false;
+      parsed.removeOccurrence( parsed.findOrAddOption( K, Slot, options.size() ), 0 );
+      for ( std::size_t j = i; j < started.size(); ++j )
+      {
+        if ( started[j].key == K )
+        {
+          --started[j].occurrenceIndex;
+        }
+      }
+    }
+  }
+
+  // What they added last time otherwise stands, the environment is taken to
+  // be unchanged, and they fill in whatever else is missing.
+  for ( std::size_t slot = 0; slot < options.size(); ++slot )
+  {
+    if ( !parsed.get( OptionHandle{ slot } ) )
+    {
+      entry.fromFinish[slot] = true;
+    }
+  }
+  parser.addFromEnvironment();
+  parser.addDefaults();
+  for ( std::size_t slot = 0; slot < options.size(); ++slot )
+  {
+    if ( entry.fromFinish[slot] && !parsed.get( OptionHandle{ slot } ) )
+    {
+      entry.fromFinish[slot] = false;
+    }
+  }
+
+  entry.arguments.resize( argc );
+  for ( std::size_t i = length; i < argc; ++i )
+  {
+    entry.arguments[i] = argv[i];
+  }
+  entry.prefixHashes = hashes;
+  entry.lastUsed = clock;
+  entry.valid = cacheable;
+  return parsed;
+}
+
+
+template< class Key, class Hash >
+std::size_t ParseCache<Key, Hash>::rollBack( Entry& entry, std::size_t length, Parser& parser ) const
+{
+  auto& parsed{ entry.parsed };
+
+  // Undo the options started from length on, latest first.
+  auto& started{ parsed.optionsByArgvPosition };
+  while ( !started.empty() && ( started.back().positionIndex >= length ) )
+  {
+    const std::size_t Slot{ options.handle( started.back().key ).slot };
+    auto& option{ parsed.findOrAddOption( started.back().key, Slot, options.size() ) };
+    parsed.removeOccurrence( option, option.occurrences.size() - 1 );
+    if ( option.occurrences.empty() )
+    {
+      parsed.removeOption( Slot );
+    }
+    started.pop_back();
+  }
+
+  // The last option started keeps as many of the arguments after its flag as
+  // it took, the rest were trailing values.
+  const typename Parser::Definition* current{ nullptr };
+  bool isLong{ false };
+  std::size_t firstTrailing{ 1 };
+  if ( !started.empty() )
+  {
+    const auto& last{ started.back() };
+    const std::string_view flag{ entry.arguments[ last.positionIndex ] };
+    isLong = ( flag.size() > 1 ) && ( flag[1] == '-' );
+    current = isLong ? options.findLong( flag.substr( 2 ) ) : options.findShort( flag.back() );
+
+    auto& values{ parsed.findOrAddOption( last.key, options.slotOf( *current ), options.size() ).occurrences.back().values };
+    parsed.truncateValues( values, std::min( values.size(), length - 1 - last.positionIndex ) );
+    firstTrailing = last.positionIndex + 1 + values.size();
+  }
+  parsed.truncateValues( parsed.trailingValues, 0 );
+  for ( std::size_t i = firstTrailing; i < length; ++i )
+  {
+    parsed.addValue( parsed.trailingValues, entry.arguments[i] );
+  }
+
+  parser.resume( length - 1, current, isLong );
+  return started.size();
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_PARSECACHE_H
@@ -0,0 +1,261 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_PARSEERROR_H
+#define LIB_LB_OPTIONS_PARSEERROR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief What went wrong with a command line. */
+enum class ParseErrorCode : std::uint8_t
+{
+  eNone,
+  eEmptyCommandLine,   //!< Not even the executable
+  eUnknownShortOption,
+  eUnknownLongOption,
+  eTooFewValues,
+  eTooManyValues,
+  eUnknownSubcommand,
+};
+
+
+/** \brief Why a parse failed, without allocating.
+
+    The \a flag is the offending argument or option flag. It refers into argv,
+    into the option definitions or, for an argument from a response file, into
+    the result parsed so far, which keeps the file mapped. For a value count
+    from an environment variable \a variable is its name and \a argvIndex is 0.
+    An unknown short option in a cluster, e.g. the x of -axb, has
+    \a characterOffset set to its offset within the argument, 2 here.
+ */
+struct ParseError
+{
+  ParseErrorCode code{ ParseErrorCode::eNone };
+  std::size_t argvIndex{ 0 }; //!< With response files expanded, as for ParsedOptions::ArgvEntry
+  std::string_view flag{};
+  std::string_view variable{};
+  std::size_t characterOffset{ 0 };
+
+  explicit operator bool() const { return code != ParseErrorCode::eNone; }
+};
+
+
+/** \brief The message that the throwing parse functions give for \a error. */
+inline std::string describe( const ParseError& error )
+{
+  std::string message;
+  switch ( error.code )
+  {
+    case ParseErrorCode::eNone:
+      break;
+    case ParseErrorCode::eEmptyCommandLine:
+      message = "Empty command line, expected at least the executable";
+      break;
+    case ParseErrorCode::eUnknownShortOption:
+      message.append( "Unknown short option " ).append( error.flag );
+      break;
+    case ParseErrorCode::eUnknownLongOption:
+      message.append( "Unknown long option " ).append( error.flag );
+      break;
+    case ParseErrorCode::eTooFewValues:
+      message.append( "Too few values for option " ).append( error.flag );
+      break;
+    case ParseErrorCode::eTooManyValues:
+      message.append( "Too many values for option " ).append( error.flag );
+      break;
+    case ParseErrorCode::eUnknownSubcommand:
+      message.append( "Unknown subcommand " ).append( error.flag );
+      break;
+  }
+  if ( !error.variable.empty() )
+  {
+    message.append( " from environment variable " ).append( error.variable );
+  }
+  return message;
+}
+
+
+/** \brief Throw std::runtime_error with the message for \a error, if any. */
+inline void throwIfError( const ParseError& error )
+{
+  if ( error )
+  {
+    throw std::runtime_error{ describe( error ) };
+  }
+}
+
+
+/** \brief Every error found in one command line, see Options::diagnose.
+
+    The records go into storage reserved up front for \a capacity of them. Any
+    errors beyond that are only counted so a command line with thousands of bad
+    arguments costs no more than one with \a capacity. Reuse an instance across
+    parses to avoid allocating at all.
+ */
+template< class Key >
+class ParseDiagnostics
+{
+public:
+  /** \brief One error and the option it concerns, if known. */
+  struct Record
+  {
+    ParseError error;
+    const Key* key; //!< Refers into the option definitions, nullptr for an unknown flag or subcommand
+  };
+
+  explicit ParseDiagnostics( std::size_t capacity = 64 )
+    : capacity{ capacity }
+  {
+    records.reserve( capacity );
+  }
+
+  /** \brief Forget the errors but keep the storage. */
+  void clear()
+  {
+    records.clear();
+    numDropped = 0;
+  }
+
+  /** \brief Record \a error, or only count it if already at capacity. */
+  void add( const ParseError& error, const Key* key )
+  {
+    if ( records.size() < capacity )
+    {
+      records.push_back( { error, key } );
+    }
+    else
+    {
+      ++numDropped;
+    }
+  }
+
+  /** \brief Add \a offset to the argv index of the records from
+             \a firstRecord on, for errors found in a nested parse.
+   */
+  void offsetArgvIndices( std::size_t firstRecord, std::size_t offset )
+  {
+    for ( auto i = firstRecord; i < records.size(); ++i )
+    {
+      if ( records[i].error.argvIndex > 0 )
+      {
+        records[i].error.argvIndex += offset;
+      }
+    }
+  }
+
+  bool empty() const { return records.empty() && ( numDropped == 0 ); }
+
+  /** \brief The number of errors found, recorded or not. */
+  std::size_t size() const { return records.size() + numDropped; }
+
+  /** \brief The errors recorded, in the order found. */
+  const std::vector<Record>& getRecords() const { return records; }
+
+  /** \brief The number of errors found beyond the capacity. */
+  std::size_t getNumDropped() const { return numDropped; }
+
+  /** \brief A line per recorded error, as "argv[i]: message". */
+  std::string describe() const
+  {
+    std::string message;
+    for ( const auto& record : records )
+    {
+      message.append( "argv[" ).append( std::to_string( record.error.argvIndex ) ).append( "]: " )
+             .append( lb::options::describe( record.error ) ).append( 1, '\n' );
+    }
+    if ( numDropped > 0 )
+    {
+      message.append( "and " ).append( std::to_string( numDropped ) ).append( " more\n" );
+    }
+    return message;
+  }
+
+private:
+  std::size_t capacity;
+  std::vector<Record> records;
+  std::size_t numDropped{ 0 };
+};
+
+
+/** \brief The outcome of a parse that does not throw, see Options::tryParse.
+
+    Much as std::expected, test it then take the result with * or -> or the
+    error with getError. On failure the result holds whatever was parsed
+    before the error, which keeps \a getError().flag valid.
+ */
+template< class Parsed >
+class ParseResult
+{
+public:
+  ParseResult( Parsed p, ParseError e )
+    : parsed{ std::move( p ) }, error{ e } {}
+
+  bool hasValue() const { return !error; }
+  explicit operator bool() const { return hasValue(); }
+
+  const ParseError& getError() const { return error; }
+
+  /** \brief The result.
+      \throw std::runtime_error with the error's message if the parse failed.
+   */
+        Parsed& getValue()       { throwIfError( error ); return parsed; }
+  const Parsed& getValue() const { throwIfError( error ); return parsed; }
+
+  /** \brief The result, which must have been parsed without error. */
+        Parsed& operator*()       { return parsed; }
+  const Parsed& operator*() const { return parsed; }
+        Parsed* operator->()       { return &parsed; }
+  const Parsed* operator->() const { return &parsed; }
+
+private:
+  Parsed parsed;
+  ParseError error;
+};
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_PARSEERROR_H
@@ -28,7 +28,11 @@
     For more information, please refer to <https://unlicense.org>
 */
 
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 
@@ -40,15 +44,67 @@ namespace options
 {
 
 
-struct ParsedOption
+/** \brief The occurrences of a single option and their values.
+
+    \a String is the type used to hold each value. ParsedOption owns its values
+    whereas ParsedOptionView merely refers to them (see Options::parseView).
+
+    All storage comes from \a Allocator. The allocator extended constructors
+    are there so that a polymorphic allocator is handed down from the
+    containers holding this (see pmr::ParsedOption).
+ */
+template< class String, class Allocator = std::allocator<String> >
+struct BasicParsedOption
 {
+  using allocator_type = Allocator;
+
+  template< class T >
+  using Vector = std::vector< T, typename std::allocator_traits<Allocator>::template rebind_alloc<T> >;
+
   struct Occurrence
   {
-    std::vector< std::string > values;
+    using allocator_type = Allocator;
+
+    Occurrence() = default;
+    Occurrence( const Occurrence& ) = default;
+    Occurrence( Occurrence&& ) = default;
+    Occurrence& operator=( const Occurrence& ) = default;
+    Occurrence& operator=( Occurrence&& ) = default;
+
+    explicit Occurrence( const allocator_type& a ) : values( a ) {}
+    Occurrence( const Occurrence& o, const allocator_type& a ) : values( o.values, a ) {}
+    Occurrence( Occurrence&& o, const allocator_type& a ) : values( std::move( o.values ), a ) {}
+
+    Vector< String > values;
   };
-  std::vector< Occurrence > occurrences;
+
+  BasicParsedOption() = default;
+  BasicParsedOption( const BasicParsedOption& ) = default;
+  BasicParsedOption( BasicParsedOption&& ) = default;
+  BasicParsedOption& operator=( const BasicParsedOption& ) = default;
+  BasicParsedOption& operator=( BasicParsedOption&& ) = default;
+
+  explicit BasicParsedOption( const allocator_type& a ) : occurrences( a ) {}
+  BasicParsedOption( const BasicParsedOption& o, const allocator_type& a ) : occurrences( o.occurrences, a ) {}
+  BasicParsedOption( BasicParsedOption&& o, const allocator_type& a ) : occurrences( std::move( o.occurrences ), a ) {}
+
+  Vector< Occurrence > occurrences;
 };
 
+using ParsedOption     = BasicParsedOption< std::string >;
+using ParsedOptionView = BasicParsedOption< std::string_view >;
+
+
+namespace pmr
+{
+
+
+/** \brief A ParsedOption whose storage all comes from one memory resource. */
+using ParsedOption = BasicParsedOption< std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string> >;
+
+
+} // End of namespace pmr
+
 
 } // End of namespace options
 
@@ -28,10 +28,20 @@
     For more information, please refer to <https://unlicense.org>
 */
 
+#include <lb/options/DenseMap.h>
+#include <lb/options/EnumCount.h>
+#include <lb/options/MappedFile.h>
+#include <lb/options/OptionHandle.h>
 #include <lb/options/ParsedOption.h>
 
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 
@@ -43,12 +53,105 @@ namespace options
 {
 
 
-template< class Key, class Hash = std::hash<Key> >
-struct ParsedOptions
+/** \brief The result of parsing an {argc, argv} set.
+
+    \a String is the type used to hold the executable and all values. Use the
+    ParsedOptions alias for a result that owns its strings or ParsedOptionsView
+    for one that refers directly into argv (see Options::parseView).
+
+    All storage comes from \a Allocator. With a polymorphic allocator (see
+    pmr::ParsedOptions) every node, vector and string of a parse can come from
+    a single arena.
+
+    If EnumCount is specialised for \a Key then optionsByKey is a DenseMap
+    rather than a std::unordered_map (and \a Hash goes unused).
+ */
+template< class Key, class Hash, class String, class Allocator = std::allocator<String> >
+struct BasicParsedOptions
 {
-  std::string executable;
-  std::unordered_map< Key, ParsedOption, Hash > optionsByKey;
-  std::vector< std::string > trailingValues;
+  using allocator_type = Allocator;
+  using string_type = String;
+  using Option = BasicParsedOption<String, Allocator>;
+
+  template< class T >
+  using Vector = typename Option::template Vector<T>;
+
+  static constexpr bool IsDense{ hasEnumCount<Key> };
+
+  using OptionsByKeyAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<
+                                  std::pair<const Key, Option> >;
+  using OptionsByKey = std::conditional_t< IsDense
+                                         , DenseMap< Key, Option, OptionsByKeyAllocator >
+                                         , std::unordered_map< Key, Option, Hash, std::equal_to<Key>
+                                                             , OptionsByKeyAllocator > >;
+
+  BasicParsedOptions() = default;
+
+  explicit BasicParsedOptions( const allocator_type& a )
+    : executable( emptyString( a ) ), optionsByKey( a ), trailingValues( a ), optionsByArgvPosition( a )
+    , mappedFiles( a ), bySlot( a ), spare( a ) {}
+
+  /** \brief A result with only its executable set, as ParsedOptions{ argv[0] }
+             gave when this was an aggregate.
+   */
+  explicit BasicParsedOptions( std::string_view e, const allocator_type& a = allocator_type() )
+    : BasicParsedOptions( a )
+  {
+    executable = e;
+  }
+
+  // The slots point into optionsByKey so must be repointed at our own copy.
+  BasicParsedOptions( const BasicParsedOptions& other )
+    : executable( other.executable ), optionsByKey( other.optionsByKey ), trailingValues( other.trailingValues )
+    , optionsByArgvPosition( other.optionsByArgvPosition ), mappedFiles( other.mappedFiles )
+    , subcommand( copySubcommand( other ) ), bySlot( other.bySlot ), spare( other.spare )
+  {
+    repointSlots();
+  }
+
+  // Only the map of options can throw when moved, so containers of results
+  // can move them if it does not.
+  BasicParsedOptions( BasicParsedOptions&& other ) noexcept( std::is_nothrow_move_constructible_v<OptionsByKey> )
+    : executable( std::move( other.executable ) ), optionsByKey( std::move( other.optionsByKey ) )
+    , trailingValues( std::move( other.trailingValues ) )
+    , optionsByArgvPosition( std::move( other.optionsByArgvPosition ) )
+    , mappedFiles( std::move( other.mappedFiles ) ), subcommand( std::move( other.subcommand ) )
+    , bySlot( std::move( other.bySlot ) ), spare( std::move( other.spare ) )
+  {
+    repointSlots();
+  }
+
+  BasicParsedOptions& operator=( const BasicParsedOptions& other )
+  {
+    executable = other.executable;
+    optionsByKey = other.optionsByKey;
+    trailingValues = other.trailingValues;
+    optionsByArgvPosition = other.optionsByArgvPosition;
+    mappedFiles = other.mappedFiles;
+    subcommand = copySubcommand( other );
+    bySlot = other.bySlot;
+    spare = other.spare;
+    repointSlots();
+    return *this;
+  }
+
+  BasicParsedOptions& operator=( BasicParsedOptions&& other )
+  {
+    executable = std::move( other.executable );
+    optionsByKey = std::move( other.optionsByKey );
+    trailingValues = std::move( other.trailingValues );
+    optionsByArgvPosition = std::move( other.optionsByArgvPosition );
+    mappedFiles = std::move( other.mappedFiles );
+    subcommand = std::move( other.subcommand );
+    bySlot = std::move( other.bySlot );
+    spare = std::move( other.spare );
+    repointSlots();
+    return *this;
+  }
+
+  String executable;
+  OptionsByKey optionsByKey;
+  Vector< String > trailingValues;
 
   /** \brief Gives the position index withing argv of each {Key, occurrence} pair.
 
@@ -60,6 +163,9 @@ struct ParsedOptions
 
       Note that options absent from argv that have default values and which are
       therefore added to optinosByKey will *not* appear here.
+
+      If response files were expanded the positions are those within argv as
+      it would be with each \@path replaced by the file's arguments.
   */
   struct ArgvEntry
   {
@@ -70,7 +176,34 @@ struct ParsedOptions
     Key key;                //!< The key of the option at this index.
     size_t occurrenceIndex; //!< The occurrence index of \a key at this position index.
   };
-  std::vector<ArgvEntry> optionsByArgvPosition;
+  Vector<ArgvEntry> optionsByArgvPosition;
+
+  /** \brief Files mapped during the parse that the values refer into.
+
+      Only kept for a result holding views, to keep the views valid for as long
+      as it (or a copy) lives.
+   */
+  Vector< std::shared_ptr<const MappedFile> > mappedFiles;
+
+  /** \brief The result for the subcommand invoked after these options, if
+             any, see Options::addSubcommand.
+
+      Its executable is the subcommand's name and its argv positions count
+      from there. A subcommand may have a subcommand in turn, see
+      getSubcommandPath.
+   */
+  std::unique_ptr< BasicParsedOptions > subcommand;
+
+  /** \brief The names of the subcommands invoked, outermost first. */
+  std::vector< std::string_view > getSubcommandPath() const
+  {
+    std::vector< std::string_view > path;
+    for ( const auto* s = subcommand.get(); s; s = s->subcommand.get() )
+    {
+      path.emplace_back( s->executable );
+    }
+    return path;
+  }
 
   /** \brief Helper to check if a \a key is present or not.
       \return True if there is at least one occurrence of the \a key.
@@ -87,9 +220,9 @@ struct ParsedOptions
             arguments. Really intended for single argument options where they
             appear more than once and the last one wins.
    */
-  std::string getLatestValue( const Key& key ) const
+  String getLatestValue( const Key& key ) const
   {
-    std::string latest;
+    String latest;
     const auto I{ optionsByKey.find( key ) };
     if ( I != optionsByKey.end() )
     {
@@ -101,8 +234,311 @@ struct ParsedOptions
     }
     return latest;
   }
+
+  /** \brief Look up an option by \a handle (see Options::handle).
+      \return The option or nullptr if it is not present.
+      \note Handles see the result as parsed, erasing from optionsByKey
+            directly leaves them referring to the erased entry.
+   */
+  const Option* get( OptionHandle handle ) const
+  {
+    const auto* const entry{ handle.slot < bySlot.size() ? bySlot[ handle.slot ] : nullptr };
+    return entry ? &entry->second : nullptr;
+  }
+
+  /** \brief As getLatestValue( key ) but by \a handle and without a copy.
+      \return The value, which refers into this instance, or an empty view.
+   */
+  std::string_view getLatestValue( OptionHandle handle ) const
+  {
+    const Option* const option{ get( handle ) };
+    if ( option )
+    {
+      const auto& values{ option->occurrences.back().values };
+      if ( !values.empty() )
+      {
+        return values.back();
+      }
+    }
+    return {};
+  }
+
+  /** \brief Empty the result but keep hold of its storage.
+
+      The map nodes, occurrences and value strings are set aside rather than
+      freed and are handed out again by findOrAddOption, addOccurrence and
+      addValue so that parsing a similar command line into this instance again
+      (see Options::parseInto) need not allocate at all.
+   */
+  void clear()
+  {
+    executable = std::string_view{};
+    if constexpr ( IsDense )
+    {
+      // Every key keeps its own entry anyway.
+      optionsByKey.clear( [this]( Option& option ) { recycle( option.occurrences ); } );
+    }
+    else
+    {
+      while ( !optionsByKey.empty() )
+      {
+        auto node{ optionsByKey.extract( optionsByKey.begin() ) };
+        recycle( node.mapped().occurrences );
+        // A key is never in both maps so this always succeeds.
+        spare.options.insert( std::move( node ) );
+      }
+    }
+    recycle( trailingValues );
+    optionsByArgvPosition.clear();
+    mappedFiles.clear();
+    if ( subcommand )
+    {
+      subcommand->clear();
+      spare.subcommand = std::move( subcommand );
+    }
+    bySlot.clear();
+  }
+
+  /** \brief Start the result for a subcommand, reusing the storage of the
+             last one if there was one, see subcommand.
+   */
+  BasicParsedOptions& addSubcommand()
+  {
+    if ( spare.subcommand )
+    {
+      subcommand = std::move( spare.subcommand );
+    }
+    else
+    {
+      subcommand = std::make_unique<BasicParsedOptions>( allocator_type( trailingValues.get_allocator() ) );
+    }
+    return *subcommand;
+  }
+
+  /** \brief Get the entry for \a key, adding it (preferably from the spares) if absent.
+
+      \a slot is the position of the key's definition in the options being
+      parsed against (of which there are \a numSlots), see OptionHandle.
+   */
+  Option& findOrAddOption( const Key& key, std::size_t slot, std::size_t numSlots )
+  {
+    if ( bySlot.size() != numSlots )
+    {
+      bySlot.assign( numSlots, nullptr );
+    }
+    auto& entry{ bySlot[ slot ] };
+    if ( !entry )
+    {
+      entry = &addOption( key );
+    }
+    return entry->second;
+  }
+
+  /** \brief Append an empty occurrence to \a option, reusing a spare if there is one. */
+  typename Option::Occurrence& addOccurrence( Option& option )
+  {
+    if ( spare.occurrences.empty() )
+    {
+      return option.occurrences.emplace_back();
+    }
+    option.occurrences.push_back( std::move( spare.occurrences.back() ) );
+    spare.occurrences.pop_back();
+    return option.occurrences.back();
+  }
+
+  /** \brief Append \a value to \a values, reusing a spare string if there is one. */
+  void addValue( Vector< String >& values, std::string_view value )
+  {
+    if ( spare.values.empty() )
+    {
+      values.emplace_back( value );
+      return;
+    }
+    values.push_back( std::move( spare.values.back() ) );
+    spare.values.pop_back();
+    values.back() = value;
+  }
+
+  /** \brief Remove occurrence \a index of \a option, setting its storage
+             aside as clear() does. For rolling a result back, see ParseCache.
+   */
+  void removeOccurrence( Option& option, std::size_t index )
+  {
+    const auto O{ option.occurrences.begin() + index };
+    recycle( O->values );
+    spare.occurrences.push_back( std::move( *O ) );
+    option.occurrences.erase( O );
+  }
+
+  /** \brief Shorten \a values to \a size, setting the rest aside. */
+  void truncateValues( Vector< String >& values, std::size_t size )
+  {
+    while ( values.size() > size )
+    {
+      spare.values.push_back( std::move( values.back() ) );
+      values.pop_back();
+    }
+  }
+
+  /** \brief Remove the option at \a slot (see findOrAddOption), if present,
+             setting its storage aside as clear() does.
+   */
+  void removeOption( std::size_t slot )
+  {
+    Entry* const entry{ slot < bySlot.size() ? bySlot[ slot ] : nullptr };
+    if ( !entry )
+    {
+      return;
+    }
+    bySlot[ slot ] = nullptr;
+    recycle( entry->second.occurrences );
+    if constexpr ( IsDense )
+    {
+      optionsByKey.erase( entry->first );
+    }
+    else
+    {
+      spare.options.insert( optionsByKey.extract( entry->first ) );
+    }
+  }
+
+private:
+  using Entry = typename OptionsByKey::value_type;
+
+  Entry& addOption( const Key& key )
+  {
+    if constexpr ( IsDense )
+    {
+      optionsByKey[ key ];
+      return *optionsByKey.find( key );
+    }
+    else
+    {
+      if ( spare.options.empty() )
+      {
+        return *optionsByKey.try_emplace( key ).first;
+      }
+      // The one we had for this key last time is likely the best fit.
+      auto node{ spare.options.extract( key ) };
+      if ( node.empty() )
+      {
+        node = spare.options.extract( spare.options.begin() );
+        node.key() = key;
+      }
+      return *optionsByKey.insert( std::move( node ) ).position;
+    }
+  }
+
+  void repointSlots()
+  {
+    for ( auto& entry : bySlot )
+    {
+      if ( entry )
+      {
+        entry = &*optionsByKey.find( entry->first );
+      }
+    }
+  }
+
+  void recycle( Vector< typename Option::Occurrence >& occurrences )
+  {
+    for ( auto& occurrence : occurrences )
+    {
+      recycle( occurrence.values );
+      spare.occurrences.push_back( std::move( occurrence ) );
+    }
+    occurrences.clear();
+  }
+
+  void recycle( Vector< String >& values )
+  {
+    for ( auto& value : values )
+    {
+      spare.values.push_back( std::move( value ) );
+    }
+    values.clear();
+  }
+
+  /** \brief Storage set aside by clear().
+
+      Not worth copying, a copy starts with no spares and assignment keeps
+      whatever spares the target already had.
+   */
+  struct Spare
+  {
+    Spare() = default;
+    explicit Spare( const allocator_type& a ) : options( a ), occurrences( a ), values( a ) {}
+    Spare( const Spare& ) {}
+    Spare( Spare&& ) = default;
+    Spare& operator=( const Spare& ) { return *this; }
+    Spare& operator=( Spare&& ) = default;
+
+    // A DenseMap needs no spare entries.
+    struct NoOptions
+    {
+      NoOptions() = default;
+      explicit NoOptions( const allocator_type& ) {}
+    };
+
+    std::conditional_t< IsDense, NoOptions, OptionsByKey > options;
+    Vector< typename Option::Occurrence > occurrences;
+    Vector< String > values;
+    std::unique_ptr< BasicParsedOptions > subcommand;
+  };
+  // The entry in optionsByKey for each definition slot, if present.
+  Vector< Entry* > bySlot;
+
+  Spare spare;
+
+  static std::unique_ptr< BasicParsedOptions > copySubcommand( const BasicParsedOptions& other )
+  {
+    return other.subcommand ? std::make_unique<BasicParsedOptions>( *other.subcommand ) : nullptr;
+  }
+
+  // A string_view has no allocator to hand over.
+  static String emptyString( const allocator_type& a )
+  {
+    if constexpr ( std::uses_allocator_v<String, Allocator> )
+    {
+      return String( a );
+    }
+    else
+    {
+      return String();
+    }
+  }
 };
 
+template< class Key, class Hash = std::hash<Key> >
+using ParsedOptions = BasicParsedOptions< Key, Hash, std::string >;
+
+/** \brief A ParsedOptions whose strings all refer to memory it does not own.
+
+    Values and the executable refer directly into the argv that was parsed and
+    any default values refer into the Options instance that did the parsing so
+    both must outlive the view.
+ */
+template< class Key, class Hash = std::hash<Key> >
+using ParsedOptionsView = BasicParsedOptions< Key, Hash, std::string_view >;
+
+
+namespace pmr
+{
+
+
+/** \brief A ParsedOptions whose storage all comes from one memory resource.
+
+    Construct it with the resource (or let Options::parse do so). Hand it a
+    std::pmr::monotonic_buffer_resource and a whole parse is carved out of one
+    buffer and released in one step when the resource is.
+ */
+template< class Key, class Hash = std::hash<Key> >
+using ParsedOptions = BasicParsedOptions< Key, Hash, std::pmr::string
+                                        , std::pmr::polymorphic_allocator<std::pmr::string> >;
+
+
+} // End of namespace pmr
+
 
 } // End of namespace options
 
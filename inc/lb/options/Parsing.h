@@ -0,0 +1,852 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_PARSING_H
+#define LIB_LB_OPTIONS_PARSING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <lb/options/ConfigFile.h>
+#include <lb/options/MappedFile.h>
+#include <lb/options/OptionHandle.h>
+#include <lb/options/ParseError.h>
+#include <lb/options/ParsedOptions.h>
+#include <lb/options/ResponseFile.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief The option currently collecting values during a parse. */
+template< class Definition, class ParsedOption >
+struct Parsing
+{
+  Parsing( const Definition& o
+         , std::string_view invocationFlag
+         , ParsedOption& p
+         , std::size_t position )
+    : option{ o }, invocationFlag{ invocationFlag }, parsedOption{ p }, position{ position } {}
+
+  const Definition& option;
+  const std::string_view invocationFlag; //!< Refers into the definition
+  ParsedOption& parsedOption;
+  const std::size_t position; //!< Of the flag in argv
+};
+
+
+/** \brief True if \a numValues is fewer than \a option requires. */
+template< class Definition >
+bool tooFewValues( const Definition& option, std::size_t numValues )
+{
+  return ( option.option.minNumValues > -1 )
+      && ( numValues < static_cast<std::size_t>( option.option.minNumValues ) );
+}
+
+
+/** \brief True if \a numValues is as many as \a option can take. */
+template< class Definition >
+bool isFull( const Definition& option, std::size_t numValues )
+{
+  return ( option.option.maxNumValues > -1 )
+      && ( numValues == static_cast<std::size_t>( option.option.maxNumValues ) );
+}
+
+
+/** \brief Call \a f with each value that the environment variable \a value
+           gives \a option, see ArgvParser::addFromEnvironment.
+    \return False if \a f returned false, which stops the calls
+ */
+template< class Definition, class F >
+bool forEachEnvironmentValue( const Definition& option, std::string_view value, F&& f )
+{
+  if ( option.option.maxNumValues == 1 )
+  {
+    return f( value );
+  }
+  if ( option.option.maxNumValues != 0 )
+  {
+    while ( !value.empty() )
+    {
+      const auto Begin{ value.find_first_not_of( " \t" ) };
+      if ( Begin == std::string_view::npos )
+      {
+        break;
+      }
+      value.remove_prefix( Begin );
+      const auto End{ std::min( value.find_first_of( " \t" ), value.size() ) };
+      if ( !f( value.substr( 0, End ) ) )
+      {
+        return false;
+      }
+      value.remove_prefix( End );
+    }
+  }
+  return true;
+}
+
+
+/** \brief The parsing state machine shared by the various option containers,
+           fed one argument at a time.
+
+    The \a schema provides the lookups, it must have
+    - size() giving the number of definitions
+    - findShort( char ) and findLong( std::string_view ) returning a pointer to
+      the matching definition or nullptr
+    - slotOf( definition ) giving its position, from 0 to size() - 1
+    - forEachDefault( f ) calling f with each definition that has defaults
+    - forEachFromEnvironment( f ) calling f( definition, variable, value ) for
+      each set environment variable bound to a definition
+
+    A definition must have a \a key and an \a option with \a minNumValues and
+    \a maxNumValues (and \a defaultValues if the schema reports any).
+
+    If \a Parsed holds views then every argument fed must stay valid for as
+    long as \a parsed does, otherwise only for the call to feed.
+ */
+template< class Schema, class Parsed >
+class ArgvParser
+{
+public:
+  using Definition = typename Schema::Definition;
+  using Key = std::decay_t< decltype( std::declval<const Definition&>().key ) >;
+
+  /** \brief Parse into \a parsed, which should already be clear and have its
+             executable set.
+   */
+  ArgvParser( const Schema& s, bool allowTrailingValues, Parsed& p )
+    : schema{ s }, allowTrailingValues{ allowTrailingValues }, parsed{ p }
+  {
+    parsed.optionsByKey.reserve( schema.size() );
+  }
+
+  /** \brief Record errors in \a d and carry on rather than stopping at the
+             first, see Options::diagnose.
+
+      The try methods then only return errors they cannot get past, which is
+      none. An unknown flag is skipped, along with the values after it, and an
+      option with too few or too many values is kept as it is.
+   */
+  void collectErrors( ParseDiagnostics<Key>& d ) { diagnostics = &d; }
+
+  /** \brief Whether errors are being recorded, see collectErrors. */
+  bool isCollectingErrors() const { return diagnostics != nullptr; }
+
+  /** \brief Pass on \a error, or record it against \a option (if known) and
+             return no error when collecting errors.
+   */
+  ParseError report( const ParseError& error, const Definition* option )
+  {
+    if ( !diagnostics )
+    {
+      return error;
+    }
+    diagnostics->add( error, option ? &option->key : nullptr );
+    return {};
+  }
+
+  /** \brief Process the next argument.
+      \throw std::runtime_error on parse failure (see Options::parse)
+   */
+  void feed( std::string_view argument ) { throwIfError( tryFeed( argument ) ); }
+
+  /** \brief As feed but returning any error rather than throwing it.
+
+      This, and the other try methods, neither allocate nor unwind to report
+      an error. The parser is not to be fed further after an error.
+   */
+  ParseError tryFeed( std::string_view argument );
+
+  /** \brief Check the final option and add in the missing defaults.
+      \throw std::runtime_error on parse failure (see Options::parse)
+   */
+  void finish()
+  {
+    finishArguments();
+    addFromEnvironment();
+    addDefaults();
+  }
+
+  /** \brief The first step of finish, checking the final option.
+      \throw std::runtime_error on parse failure (see Options::parse)
+
+      Anything that should take precedence over the defaults but not over the
+      arguments, e.g. mergeConfigFile, goes between this and addDefaults.
+   */
+  void finishArguments() { throwIfError( tryFinishArguments() ); }
+
+  /** \brief As finishArguments but returning any error rather than throwing it. */
+  ParseError tryFinishArguments();
+
+  /** \brief The second step of finish, adding the missing options that are
+             bound to a set environment variable.
+      \throw std::runtime_error if a variable gives too few or too many values
+
+      A variable bound to an option that takes no values sets it whatever its
+      value. One bound to an option that takes at most one value gives that
+      value as is, otherwise the value is split on spaces and tabs.
+   */
+  void addFromEnvironment() { throwIfError( tryAddFromEnvironment() ); }
+
+  /** \brief As addFromEnvironment but returning any error rather than throwing it. */
+  ParseError tryAddFromEnvironment();
+
+  /** \brief The last step of finish, adding in the missing defaults. */
+  void addDefaults();
+
+  /** \brief Whether an argument that is not a flag fed now would be
+             positional, i.e. not a value of the option being parsed.
+   */
+  bool isPositional() const
+  {
+    return !currentlyParsing
+        || isFull( currentlyParsing->option, currentlyParsing->parsedOption.occurrences.back().values.size() );
+  }
+
+  /** \brief The position given to the last argument fed, 0 before any. */
+  std::size_t getPosition() const { return position; }
+
+  /** \brief Carry on from part way through a command line.
+
+      For when \a parsed already holds the result of feeding the arguments up
+      to and including \a lastPosition, e.g. a longer parse rolled back (see
+      ParseCache). \a current is the option that was then still collecting
+      values, if any, invoked by its long flag if \a isLong. Its last
+      occurrence must be the one that was collecting.
+   */
+  void resume( std::size_t lastPosition, const Definition* current, bool isLong );
+
+private:
+  // Close off the option we are currently parsing, if any, and start on
+  // \a option, invoked by its long flag or else its short one.
+  ParseError start( const Definition& option, bool isLong );
+
+  // The checks made on the option we are currently parsing once it is done.
+  ParseError close( bool allowExcessValues );
+
+  // When collecting errors, close off the current option and ignore the
+  // values that follow an unknown flag.
+  ParseError skip();
+
+  // The full flag even if abbreviated, and not the rest of a short cluster.
+  static std::string_view invocationFlagOf( const Definition& option, bool isLong )
+  {
+    return isLong ? std::string_view{ option.option.l } : std::string_view{ &option.option.s, 1 };
+  }
+
+  const Schema& schema;
+  const bool allowTrailingValues;
+  Parsed& parsed;
+
+  // Note that we don't yet support option values that start with a dash. We
+  // possibly could in cases where there are an exact number of expected
+  // arguments but that's for future if it is ever required.
+  std::optional<Parsing<Definition, typename Parsed::Option>> currentlyParsing;
+
+  std::size_t position{ 0 }; //!< The executable is at 0
+
+  ParseDiagnostics<Key>* diagnostics{ nullptr };
+  bool skipping{ false };
+};
+
+
+template< class Schema, class Parsed >
+ParseError ArgvParser<Schema, Parsed>::tryFeed( std::string_view s )
+{
+  ++position;
+
+  // Values we can't yet tell are trailing or in excess.
+  auto& trailingValues{ parsed.trailingValues };
+
+  if ( !s.empty() && ( s[0] == '-' ) )
+  {
+    skipping = false;
+
+    // Got a flag, is it short or long?
+    if ( ( s.size() > 1 ) && ( s[1] == '-' ) )
+    {
+      // Long flag
+      const Definition* const L{ schema.findLong( s.substr( 2 ) ) };
+      if ( !L )
+      {
+        if ( const auto error{ report( { ParseErrorCode::eUnknownLongOption, position, s.substr( 2 ) }, nullptr ) } )
+        {
+          return error;
+        }
+        return skip();
+      }
+      if ( const auto error{ start( *L, true ) } )
+      {
+        return error;
+      }
+    }
+    else // short flag, could be multiple short options all together
+    {
+      for ( std::string_view::size_type j = 1; j < s.size(); ++j )
+      {
+        const Definition* const S{ schema.findShort( s[j] ) };
+        if ( !S )
+        {
+          if ( const auto error{ report( { ParseErrorCode::eUnknownShortOption, position, s.substr( j, 1 ), {}, j }, nullptr ) } )
+          {
+            return error;
+          }
+          if ( j + 1 == s.size() )
+          {
+            return skip();
+          }
+          continue;
+        }
+        if ( const auto error{ start( *S, false ) } )
+        {
+          return error;
+        }
+      }
+    }
+
+    trailingValues.clear();
+  }
+  else if ( !skipping ) // not a flag
+  {
+    if ( currentlyParsing )
+    {
+      auto& occurrence{ currentlyParsing->parsedOption.occurrences.back() };
+
+      // Current policy is to treat excess values as an error unless they are
+      // trailing but we don't know if they are trailing values until we've
+      // finished looking for flags. So keep a note of them and if we hit
+      // another flag then we throw and if not we file them under the trailing
+      // values enumeration.
+      if ( isFull( currentlyParsing->option, occurrence.values.size() ) )
+      {
+        parsed.addValue( trailingValues, s );
+      }
+      else
+      {
+        parsed.addValue( occurrence.values, s );
+      }
+    }
+    else
+    {
+      parsed.addValue( trailingValues, s );
+    }
+  }
+  return {};
+}
+
+
+template< class Schema, class Parsed >
+ParseError ArgvParser<Schema, Parsed>::tryFinishArguments()
+{
+  // Only check for excess values here if we are not accepting trailing values.
+  if ( const auto error{ close( allowTrailingValues ) } )
+  {
+    return error;
+  }
+  currentlyParsing.reset();
+
+  if ( !allowTrailingValues )
+  {
+    parsed.trailingValues.clear();
+  }
+  return {};
+}
+
+
+template< class Schema, class Parsed >
+ParseError ArgvParser<Schema, Parsed>::tryAddFromEnvironment()
+{
+  ParseError error;
+  schema.forEachFromEnvironment( [this, &error]( const auto& option, std::string_view variable, std::string_view value )
+  {
+    if ( error || ( parsed.optionsByKey.find( option.key ) != parsed.optionsByKey.end() ) )
+    {
+      return;
+    }
+
+    auto& values{ parsed.addOccurrence( parsed.findOrAddOption( option.key, schema.slotOf( option ), schema.size() ) ).values };
+    const bool AllAdded{ forEachEnvironmentValue( option, value, [this, &option, &values]( std::string_view v )
+    {
+      if ( isFull( option, values.size() ) )
+      {
+        return false;
+      }
+      parsed.addValue( values, v );
+      return true;
+    } ) };
+    if ( !AllAdded )
+    {
+      error = report( { ParseErrorCode::eTooManyValues, 0, option.option.l, variable }, &option );
+      return;
+    }
+
+    if ( tooFewValues( option, values.size() ) )
+    {
+      error = report( { ParseErrorCode::eTooFewValues, 0, option.option.l, variable }, &option );
+    }
+  } );
+  return error;
+}
+
+
+template< class Schema, class Parsed >
+void ArgvParser<Schema, Parsed>::addDefaults()
+{
+  // Add in missing options that have defaults
+  schema.forEachDefault( [this]( const auto& option )
+  {
+    if ( parsed.optionsByKey.find( option.key ) == parsed.optionsByKey.end() )
+    {
+      auto& values{ parsed.addOccurrence( parsed.findOrAddOption( option.key, schema.slotOf( option ), schema.size() ) ).values };
+      for ( const auto& value : option.option.defaultValues )
+      {
+        parsed.addValue( values, value );
+      }
+    }
+  } );
+}
+
+
+template< class Schema, class Parsed >
+ParseError ArgvParser<Schema, Parsed>::start( const Definition& option, bool isLong )
+{
+  if ( const auto error{ close( false ) } )
+  {
+    return error;
+  }
+
+  // Add or reuse parsed map entry as required
+  currentlyParsing.emplace( option, invocationFlagOf( option, isLong )
+                          , parsed.findOrAddOption( option.key, schema.slotOf( option ), schema.size() )
+                          , position );
+  parsed.optionsByArgvPosition.emplace_back( position, option.key, currentlyParsing->parsedOption.occurrences.size() );
+  parsed.addOccurrence( currentlyParsing->parsedOption );
+  return {};
+}
+
+
+template< class Schema, class Parsed >
+void ArgvParser<Schema, Parsed>::resume( std::size_t lastPosition, const Definition* current, bool isLong )
+{
+  position = lastPosition;
+  currentlyParsing.reset();
+  if ( current )
+  {
+    currentlyParsing.emplace( *current, invocationFlagOf( *current, isLong )
+                            , parsed.findOrAddOption( current->key, schema.slotOf( *current ), schema.size() )
+                            , parsed.optionsByArgvPosition.empty() ? lastPosition
+                                                                   : parsed.optionsByArgvPosition.back().positionIndex );
+  }
+}
+
+
+template< class Schema, class Parsed >
+ParseError ArgvParser<Schema, Parsed>::close( bool allowExcessValues )
+{
+  if ( currentlyParsing )
+  {
+    if ( tooFewValues( currentlyParsing->option
+                     , currentlyParsing->parsedOption.occurrences.back().values.size() ) )
+    {
+      return report( { ParseErrorCode::eTooFewValues, currentlyParsing->position, currentlyParsing->invocationFlag }
+                   , &currentlyParsing->option );
+    }
+    if ( !allowExcessValues && !parsed.trailingValues.empty() )
+    {
+      return report( { ParseErrorCode::eTooManyValues, currentlyParsing->position, currentlyParsing->invocationFlag }
+                   , &currentlyParsing->option );
+    }
+  }
+  return {};
+}
+
+
+template< class Schema, class Parsed >
+ParseError ArgvParser<Schema, Parsed>::skip()
+{
+  if ( const auto error{ close( false ) } )
+  {
+    return error;
+  }
+  currentlyParsing.reset();
+  parsed.trailingValues.clear();
+  skipping = true;
+  return {};
+}
+
+
+/** \brief How deeply response files may include one another. */
+constexpr int MaxResponseFileDepth{ 16 };
+
+
+/** \brief Feed the arguments of the response file at \a path to \a parser.
+    \throw std::runtime_error if the file cannot be read or is malformed
+    \return Any parse error, as ArgvParser::tryFeed
+
+    The file is mapped and tokenised in place, see ResponseFileTokenizer. An
+    argument within it of the form \@path is itself expanded. If \a parsed
+    holds views, or there is an error that refers into the file, or \a parser
+    is collecting errors that may, then it keeps the mapping alive.
+ */
+template< class Parser, class Parsed >
+ParseError tryFeedResponseFile( Parser& parser, Parsed& parsed, std::string_view path, int depth )
+{
+  if ( depth > MaxResponseFileDepth )
+  {
+    throw std::runtime_error{ std::string{ "Response files nested too deeply at " }.append( path ) };
+  }
+
+  auto file{ std::make_shared<MappedFile>( std::string{ path }, MappedFile::Mode::eCopyOnWrite ) };
+  ResponseFileTokenizer tokenizer{ file->data(), file->data() + file->size() };
+  std::string_view argument;
+  ParseError error;
+  while ( !error && tokenizer.next( argument ) )
+  {
+    if ( ( argument.size() > 1 ) && ( argument[0] == '@' ) )
+    {
+      error = tryFeedResponseFile( parser, parsed, argument.substr( 1 ), depth + 1 );
+    }
+    else
+    {
+      error = parser.tryFeed( argument );
+    }
+  }
+
+  if ( error || parser.isCollectingErrors() || std::is_same_v< typename Parsed::string_type, std::string_view > )
+  {
+    parsed.mappedFiles.push_back( std::move( file ) );
+  }
+  return error;
+}
+
+
+/** \brief As tryFeedResponseFile but throwing on parse failure too. */
+template< class Parser, class Parsed >
+void feedResponseFile( Parser& parser, Parsed& parsed, std::string_view path, int depth )
+{
+  throwIfError( tryFeedResponseFile( parser, parsed, path, depth ) );
+}
+
+
+/** \brief Add the settings of the config file at \a path to \a parsed for
+           the options not already in it.
+    \throw std::runtime_error if the file cannot be read or is malformed, a
+           setting is for an unknown option or it has too few or too many
+           values. The message gives the file and line.
+
+    The file is read as described by ConfigFileReader, each name being the long
+    flag of an option, and is parsed straight from a mapping of it. A setting
+    counts as one occurrence of its option, so a name given on several lines
+    is like a flag given several times on the command line. Options that were
+    present in \a parsed beforehand are skipped whole: this is meant to be run
+    after the arguments but before the defaults (see
+    ArgvParser::finishArguments) so the command line wins over the file and
+    the file over the defaults.
+
+    If \a parsed holds views then it keeps the mapping alive, even if this
+    throws part way through the file.
+ */
+template< class Schema, class Parsed >
+void mergeConfigFile( const Schema& schema, Parsed& parsed, std::string_view path )
+{
+  auto file{ std::make_shared<MappedFile>( std::string{ path }, MappedFile::Mode::eCopyOnWrite ) };
+  ConfigFileReader reader{ file->data(), file->data() + file->size() };
+  if constexpr ( std::is_same_v< typename Parsed::string_type, std::string_view > )
+  {
+    // Held from the start as values added before a failure view it too.
+    parsed.mappedFiles.push_back( file );
+  }
+
+  // Which options the file may not touch, decided before it adds any.
+  std::vector<bool> isOverridden( schema.size() );
+  for ( std::size_t slot = 0; slot < isOverridden.size(); ++slot )
+  {
+    isOverridden[slot] = parsed.get( OptionHandle{ slot } ) != nullptr;
+  }
+
+  std::string qualifiedName;
+  try
+  {
+    ConfigFileReader::Setting setting;
+    while ( reader.next( setting ) )
+    {
+      std::string_view name{ setting.name };
+      if ( !setting.section.empty() )
+      {
+        qualifiedName.assign( setting.section ).append( 1, '.' ).append( setting.name );
+        name = qualifiedName;
+      }
+
+      const auto* const option{ schema.findLong( name ) };
+      if ( !option )
+      {
+        throw std::runtime_error{ std::string{ "Unknown option " }.append( name ) };
+      }
+      const std::size_t Slot{ schema.slotOf( *option ) };
+      if ( isOverridden[Slot] )
+      {
+        continue;
+      }
+
+      auto& values{ parsed.addOccurrence( parsed.findOrAddOption( option->key, Slot, schema.size() ) ).values };
+      ResponseFileTokenizer tokenizer{ setting.valuesBegin, setting.valuesEnd };
+      std::string_view value;
+      while ( tokenizer.next( value ) )
+      {
+        if ( isFull( *option, values.size() ) )
+        {
+          throw std::runtime_error{ std::string{ "Too many values for option " }.append( name ) };
+        }
+        parsed.addValue( values, value );
+      }
+      if ( tooFewValues( *option, values.size() ) )
+      {
+        throw std::runtime_error{ std::string{ "Too few values for option " }.append( name ) };
+      }
+    }
+  }
+  catch ( const std::runtime_error& e )
+  {
+    throw std::runtime_error{ std::string{ path }.append( 1, ':' )
+                                                 .append( std::to_string( reader.getLineNumber() ) )
+                                                 .append( ": " )
+                                                 .append( e.what() ) };
+  }
+}
+
+
+/** \brief True if \a Schema can have subcommands, i.e. has hasSubcommands()
+           and findSubcommand( name ) returning a schema of its own type or
+           nullptr, see Options::addSubcommand.
+ */
+template< class Schema, class = void >
+struct SupportsSubcommands : std::false_type {};
+
+template< class Schema >
+struct SupportsSubcommands< Schema, std::void_t< decltype( std::declval<const Schema&>().findSubcommand( std::string_view{} ) ) > >
+  : std::true_type {};
+
+template< class Schema >
+inline constexpr bool supportsSubcommands{ SupportsSubcommands<Schema>::value };
+
+
+/** \brief Parse the command line [\a first, \a last) against a set of option
+           definitions.
+    \throw std::runtime_error on parse failure (see Options::parse)
+
+    The range is laid out as argv is, the executable then the arguments, and
+    each element must convert to std::string_view. The \a schema is as for
+    ArgvParser. The \a config must have \a allowTrailingValues and
+    \a expandResponseFiles, if the latter is set then an argument \@path is
+    replaced by the arguments in the file at path (see feedResponseFile).
+
+    Options missing from the command line are taken from the environment
+    (see ArgvParser::addFromEnvironment) then, if \a configPath is not empty,
+    from the config file there (see mergeConfigFile) and only then from their
+    defaults.
+
+    If the \a schema has subcommands (see Options::addSubcommand) then the
+    first positional argument (see ArgvParser::isPositional) on the command
+    line itself must name one. The parse of these options ends there and the
+    rest of the range, from the subcommand's name, is parsed against the
+    subcommand's options into BasicParsedOptions::subcommand. The config file
+    only applies to the outermost options.
+
+    Any previous contents of \a parsed are cleared first, its storage is
+    reused where possible (see BasicParsedOptions::clear). On failure \a parsed
+    is left holding whatever had been parsed so far.
+ */
+template< class Schema, class Config, class Iterator, class Parsed >
+void parseArgumentsInto( const Schema& schema
+                       , const Config& config
+                       , Iterator first
+                       , Iterator last
+                       , Parsed& parsed
+                       , std::string_view configPath = {} )
+{
+  throwIfError( tryParseArgumentsInto( schema, config, first, last, parsed, configPath ) );
+}
+
+
+/** \brief As parseArgumentsInto but returning an error in the command line
+           rather than throwing it.
+    \throw std::runtime_error only if a response file or the config file
+           cannot be read or is invalid, or if building a subcommand's options
+           throws.
+
+    Rejecting a command line neither allocates nor unwinds, bar whatever was
+    parsed before the error. An error from a subcommand has its argvIndex
+    counted from the start of the whole command line.
+
+    If \a diagnostics is given then every error is added to it instead and
+    no error is returned, see ArgvParser::collectErrors. After an unknown
+    subcommand the rest of the command line is ignored.
+ */
+template< class Schema, class Config, class Iterator, class Parsed >
+ParseError tryParseArgumentsInto( const Schema& schema
+                                , const Config& config
+                                , Iterator first
+                                , Iterator last
+                                , Parsed& parsed
+                                , std::string_view configPath = {}
+                                , ParseDiagnostics< typename ArgvParser<Schema, Parsed>::Key >* diagnostics = nullptr )
+{
+  parsed.clear();
+  if ( first == last )
+  {
+    const ParseError error{ ParseErrorCode::eEmptyCommandLine };
+    if ( !diagnostics )
+    {
+      return error;
+    }
+    diagnostics->add( error, nullptr );
+    return {};
+  }
+  parsed.executable = std::string_view{ *first };
+
+  ArgvParser<Schema, Parsed> parser{ schema, config.allowTrailingValues, parsed };
+  if ( diagnostics )
+  {
+    parser.collectErrors( *diagnostics );
+  }
+  const Schema* subcommand{ nullptr };
+  for ( ++first; first != last; ++first )
+  {
+    const std::string_view argument{ *first };
+    ParseError error;
+    if ( config.expandResponseFiles && ( argument.size() > 1 ) && ( argument[0] == '@' ) )
+    {
+      error = tryFeedResponseFile( parser, parsed, argument.substr( 1 ), 1 );
+    }
+    else
+    {
+      if constexpr ( supportsSubcommands<Schema> )
+      {
+        if ( schema.hasSubcommands() && ( argument.empty() || ( argument[0] != '-' ) ) && parser.isPositional() )
+        {
+          subcommand = schema.findSubcommand( argument );
+          if ( !subcommand )
+          {
+            if ( const auto error{ parser.report( { ParseErrorCode::eUnknownSubcommand, parser.getPosition() + 1, argument }, nullptr ) } )
+            {
+              return error;
+            }
+          }
+          break;
+        }
+      }
+      error = parser.tryFeed( argument );
+    }
+    if ( error )
+    {
+      return error;
+    }
+  }
+  if ( const auto error{ parser.tryFinishArguments() } )
+  {
+    return error;
+  }
+  if ( const auto error{ parser.tryAddFromEnvironment() } )
+  {
+    return error;
+  }
+  if ( !configPath.empty() )
+  {
+    mergeConfigFile( schema, parsed, configPath );
+  }
+  parser.addDefaults();
+
+  if constexpr ( supportsSubcommands<Schema> )
+  {
+    if ( subcommand )
+    {
+      const std::size_t FirstRecord{ diagnostics ? diagnostics->getRecords().size() : 0 };
+      auto error{ tryParseArgumentsInto( *subcommand, subcommand->getConfiguration(), first, last, parsed.addSubcommand()
+                                       , {}, diagnostics ) };
+      if ( error.argvIndex > 0 )
+      {
+        error.argvIndex += parser.getPosition() + 1;
+      }
+      if ( diagnostics )
+      {
+        diagnostics->offsetArgvIndices( FirstRecord, parser.getPosition() + 1 );
+      }
+      return error;
+    }
+  }
+  return {};
+}
+
+
+/** \brief Parse an {argc, argv} set against a set of option definitions, see
+           parseArgumentsInto.
+ */
+template< class Schema, class Config, class Parsed >
+void parseArgvInto( const Schema& schema
+                  , const Config& config
+                  , int argc
+                  , char** argv
+                  , Parsed& parsed )
+{
+  parseArgumentsInto( schema, config, argv, argv + argc, parsed );
+}
+
+
+/** \brief Parse into a new \a Parsed constructed with \a allocator, see parseArgvInto. */
+template< class Parsed, class Schema, class Config >
+Parsed parseArgv( const Schema& schema
+                , const Config& config
+                , int argc
+                , char** argv
+                , const typename Parsed::allocator_type& allocator = {} )
+{
+  Parsed parsed( allocator );
+  parseArgvInto( schema, config, argc, argv, parsed );
+  return parsed;
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_PARSING_H
@@ -0,0 +1,298 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_PERFECTHASH_H
+#define LIB_LB_OPTIONS_PERFECTHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief Seeded 64-bit FNV-1a hash of \a s. */
+constexpr std::uint64_t hashString( std::string_view s, std::uint64_t seed = 0 )
+{
+  std::uint64_t h{ 14695981039346656037ull ^ seed };
+  for ( const char c : s )
+  {
+    h ^= static_cast<unsigned char>( c );
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+
+/** \brief Scrambles every bit of \a h (the splitmix64 finaliser). */
+constexpr std::uint64_t mixHash( std::uint64_t h )
+{
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
+
+/** \brief The bucket that the hash \a h falls into. */
+constexpr std::size_t perfectHashBucket( std::uint64_t h, std::size_t numBuckets )
+{
+  return mixHash( h ) % numBuckets;
+}
+
+
+/** \brief The slot that the hash \a h maps to given its bucket's displacement. */
+constexpr std::size_t perfectHashSlot( std::uint64_t h
+                                     , std::uint32_t displacement
+                                     , std::size_t numSlots )
+{
+  return mixHash( h ^ ( ( displacement + 1ull ) * 0x9e3779b97f4a7c15ull ) ) % numSlots;
+}
+
+
+/** \brief The slot that the hash \a h maps to. */
+constexpr std::size_t perfectHashLookup( std::uint64_t h
+                                       , const std::uint32_t* displacements
+                                       , std::size_t numBuckets
+                                       , std::size_t numSlots )
+{
+  return perfectHashSlot( h, displacements[ perfectHashBucket( h, numBuckets ) ], numSlots );
+}
+
+
+/** \brief Build a hash and displace (CHD) perfect hash over \a n hashes.
+    \return False if some bucket could not be placed with any displacement
+            below \a maxDisplacement, which in practice means two of the
+            hashes are equal.
+
+    Hashes are distributed over \a numBuckets buckets which are then placed,
+    largest first, by searching for a displacement that maps every member of
+    the bucket to a free slot. On success slot perfectHashLookup( hashes[i] )
+    of \a slots holds i and every unused slot holds \a n. With \a numSlots
+    equal to \a n the hash is minimal.
+
+    Everything is passed as raw arrays so the same code builds tables both at
+    compile time and at run time. \a scratch needs room for
+    2 * ( numBuckets + n ) + 1 entries.
+ */
+template< class Index >
+constexpr bool buildPerfectHash( const std::uint64_t* hashes
+                               , std::size_t n
+                               , std::uint32_t* displacements
+                               , std::size_t numBuckets
+                               , Index* slots
+                               , std::size_t numSlots
+                               , std::size_t* scratch
+                               , std::uint32_t maxDisplacement )
+{
+  std::size_t* const bucketStart{ scratch };                    // numBuckets + 1
+  std::size_t* const members    { bucketStart + numBuckets + 1 }; // n, grouped by bucket
+  std::size_t* const order      { members + n };                 // numBuckets
+  std::size_t* const tentative  { order + numBuckets };          // n
+
+  // Counting sort of the hashes by bucket
+  for ( std::size_t b = 0; b <= numBuckets; ++b )
+  {
+    bucketStart[b] = 0;
+  }
+  for ( std::size_t i = 0; i < n; ++i )
+  {
+    ++bucketStart[ perfectHashBucket( hashes[i], numBuckets ) + 1 ];
+  }
+  std::size_t maxSize{ 0 };
+  for ( std::size_t b = 0; b < numBuckets; ++b )
+  {
+    if ( bucketStart[b + 1] > maxSize )
+    {
+      maxSize = bucketStart[b + 1];
+    }
+    bucketStart[b + 1] += bucketStart[b];
+  }
+  for ( std::size_t b = 0; b < numBuckets; ++b )
+  {
+    order[b] = bucketStart[b]; // used as an insertion cursor for now
+  }
+  for ( std::size_t i = 0; i < n; ++i )
+  {
+    members[ order[ perfectHashBucket( hashes[i], numBuckets ) ]++ ] = i;
+  }
+
+  // Largest buckets are the hardest to place so do them first
+  std::size_t numOrdered{ 0 };
+  for ( std::size_t size = maxSize; size > 0; --size )
+  {
+    for ( std::size_t b = 0; b < numBuckets; ++b )
+    {
+      if ( bucketStart[b + 1] - bucketStart[b] == size )
+      {
+        order[ numOrdered++ ] = b;
+      }
+    }
+  }
+
+  for ( std::size_t s = 0; s < numSlots; ++s )
+  {
+    slots[s] = static_cast<Index>( n );
+  }
+  for ( std::size_t b = 0; b < numBuckets; ++b )
+  {
+    displacements[b] = 0;
+  }
+
+  for ( std::size_t o = 0; o < numOrdered; ++o )
+  {
+    const std::size_t b    { order[o] };
+    const std::size_t first{ bucketStart[b] };
+    const std::size_t size { bucketStart[b + 1] - first };
+
+    bool placed{ false };
+    for ( std::uint32_t d = 0; !placed && ( d < maxDisplacement ); ++d )
+    {
+      placed = true;
+      for ( std::size_t m = 0; placed && ( m < size ); ++m )
+      {
+        const std::size_t slot{ perfectHashSlot( hashes[ members[first + m] ], d, numSlots ) };
+        placed = ( slots[slot] == static_cast<Index>( n ) );
+        for ( std::size_t t = 0; placed && ( t < m ); ++t )
+        {
+          placed = ( tentative[t] != slot );
+        }
+        tentative[m] = slot;
+      }
+      if ( placed )
+      {
+        displacements[b] = d;
+        for ( std::size_t m = 0; m < size; ++m )
+        {
+          slots[ tentative[m] ] = static_cast<Index>( members[first + m] );
+        }
+      }
+    }
+    if ( !placed )
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/** \brief A minimal perfect hash over a set of 64-bit hashes built at run time.
+
+    Maps each of the n hashes it was built from to a distinct index in [0, n)
+    (or a value given per hash) with one hash mix and two array loads. It knows
+    nothing of the keys the hashes came from so a caller must compare the key
+    stored at the returned index, any other hash maps to an arbitrary one.
+
+    Memory is a 32-bit displacement per four hashes plus a 32-bit index per
+    hash.
+ */
+class MinimalPerfectHash
+{
+public:
+  using Index = std::uint32_t;
+  static constexpr Index None{ ~Index{ 0 } };
+
+  MinimalPerfectHash() = default;
+
+  /** \brief Build over \a hashes, \a values[i] being found for hashes[i].
+      \return False, leaving this empty, if two of the hashes are equal.
+
+      With no \a values the index of each hash is used.
+   */
+  bool build( const std::vector<std::uint64_t>& hashes
+            , const std::vector<Index>& values = {} );
+
+  /** \brief The value that \a h may be for, or None if empty. */
+  Index find( std::uint64_t h ) const
+  {
+    if ( slots.empty() )
+    {
+      return None;
+    }
+    return slots[ perfectHashLookup( h, displacements.data(), displacements.size(), slots.size() ) ];
+  }
+
+  bool empty() const { return slots.empty(); }
+
+  /** \brief The tables, for storing the hash elsewhere, see perfectHashLookup. */
+  const std::vector< std::uint32_t >& getDisplacements() const { return displacements; }
+  const std::vector< Index >& getSlots() const { return slots; }
+
+private:
+  std::vector< std::uint32_t > displacements;
+  std::vector< Index > slots;
+};
+
+
+inline bool MinimalPerfectHash::build( const std::vector<std::uint64_t>& hashes
+                                      , const std::vector<Index>& values )
+{
+  displacements.assign( hashes.size() / 4 + 1, 0 );
+  slots.assign( hashes.size(), None );
+  std::vector<std::size_t> scratch( 2 * ( displacements.size() + hashes.size() ) + 1 );
+
+  // Filling the last few slots of a minimal table can take a displacement of
+  // the order of the table size.
+  const auto maxDisplacement{ static_cast<std::uint32_t>( 64 * hashes.size() + 1024 ) };
+  if ( !buildPerfectHash( hashes.data(), hashes.size()
+                        , displacements.data(), displacements.size()
+                        , slots.data(), slots.size()
+                        , scratch.data(), maxDisplacement ) )
+  {
+    displacements.clear();
+    slots.clear();
+    return false;
+  }
+  if ( !values.empty() )
+  {
+    for ( auto& slot : slots )
+    {
+      slot = values[slot];
+    }
+  }
+  return true;
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_PERFECTHASH_H
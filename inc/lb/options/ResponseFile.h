@@ -0,0 +1,165 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_RESPONSEFILE_H
+#define LIB_LB_OPTIONS_RESPONSEFILE_H
+
+#include <stdexcept>
+#include <string_view>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief Splits the contents of a response file into arguments, one at a
+           time and in place.
+
+    The rules are those of a shell without any expansion:
+    - arguments are separated by whitespace (including newlines)
+    - within single quotes every character is literal
+    - within double quotes a backslash escapes a double quote or a backslash
+      and is otherwise literal
+    - elsewhere a backslash escapes the following character
+    - quotes can be mixed within an argument, "" on its own is an empty one
+
+    Removing quotes and escapes only ever shortens an argument so it is done by
+    shifting characters down within the buffer, which therefore must be
+    writable (e.g. a MappedFile in copy on write mode). Each argument is a view
+    of the buffer. Characters are only written once a quote or escape has been
+    removed, so a file without any is never written to and none of its pages
+    are copied.
+ */
+class ResponseFileTokenizer
+{
+public:
+  ResponseFileTokenizer( char* begin, char* end )
+    : read{ begin }, end{ end } {}
+
+  /** \brief Get the next argument.
+      \return False once the buffer is exhausted.
+      \throw std::runtime_error on an unterminated quote or a trailing
+             backslash.
+   */
+  bool next( std::string_view& argument );
+
+private:
+  static bool isSpace( char c )
+  {
+    return ( c == ' ' ) || ( c == '\t' ) || ( c == '\n' ) || ( c == '\r' ) || ( c == '\f' ) || ( c == '\v' );
+  }
+
+  // Copy the character at \a from to \a to and advance \a to, only storing
+  // it if that changes anything.
+  static void shift( char*& to, const char* from )
+  {
+    if ( to != from )
+    {
+      *to = *from;
+    }
+    ++to;
+  }
+
+  char* read;
+  char* const end;
+};
+
+
+inline bool ResponseFileTokenizer::next( std::string_view& argument )
+{
+  while ( ( read != end ) && isSpace( *read ) )
+  {
+    ++read;
+  }
+  if ( read == end )
+  {
+    return false;
+  }
+
+  char* const begin{ read };
+  char* write{ read };
+  while ( ( read != end ) && !isSpace( *read ) )
+  {
+    const char c{ *read++ };
+    if ( c == '\'' )
+    {
+      while ( ( read != end ) && ( *read != '\'' ) )
+      {
+        shift( write, read++ );
+      }
+      if ( read == end )
+      {
+        throw std::runtime_error( "Unterminated single quote in response file" );
+      }
+      ++read;
+    }
+    else if ( c == '"' )
+    {
+      while ( ( read != end ) && ( *read != '"' ) )
+      {
+        if ( ( *read == '\\' ) && ( read + 1 != end ) && ( ( read[1] == '"' ) || ( read[1] == '\\' ) ) )
+        {
+          ++read;
+        }
+        shift( write, read++ );
+      }
+      if ( read == end )
+      {
+        throw std::runtime_error( "Unterminated double quote in response file" );
+      }
+      ++read;
+    }
+    else if ( c == '\\' )
+    {
+      if ( read == end )
+      {
+        throw std::runtime_error( "Trailing backslash in response file" );
+      }
+      shift( write, read++ );
+    }
+    else
+    {
+      shift( write, read - 1 );
+    }
+  }
+
+  argument = std::string_view( begin, write - begin );
+  return true;
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_RESPONSEFILE_H
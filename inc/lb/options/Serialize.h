@@ -0,0 +1,566 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_SERIALIZE_H
+#define LIB_LB_OPTIONS_SERIALIZE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <lb/options/ParsedOptions.h>
+#include <lb/options/Parsing.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief The start of a ParsedOptions serialized by serialize.
+
+    Every field here and in the sections that follow is a std::uint32_t in
+    native byte order, so a blob is for handing to another process on the same
+    machine rather than for storage. After the header come, in order,
+    - the options, each the key's bytes padded to a multiple of four, the index
+      of its first occurrence and its number of occurrences
+    - the occurrences, each the index of its first value and its number of
+      values
+    - the values, each the offset and size of its string in the string table,
+      the first being the executable followed by the trailing values
+    - the argv entries, each the position, the index of the option and the
+      occurrence index
+    - the string table
+    - the result of the subcommand invoked, if any, as a blob of its own
+
+    Everything is found by index or offset so a blob can be read wherever it is
+    loaded or mapped.
+ */
+struct SerializedHeader
+{
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t keySize;
+  std::uint32_t numOptions;
+  std::uint32_t numOccurrences;
+  std::uint32_t numValues; //!< Including the executable and the trailing values
+  std::uint32_t numTrailingValues;
+  std::uint32_t numArgvEntries;
+  std::uint32_t stringsSize;
+  std::uint32_t subcommandSize; //!< Of the subcommand's blob, 0 if there is none
+};
+
+constexpr std::uint32_t SerializedMagic{ 0x504f424c }; // LBOP
+constexpr std::uint32_t SerializedVersion{ 2 };
+
+
+/** \brief Where each section of a blob with header \a h starts. */
+template< class Key >
+struct SerializedLayout
+{
+  static constexpr std::size_t KeySize{ ( sizeof( Key ) + 3 ) / 4 * 4 };
+  static constexpr std::size_t OptionSize{ KeySize + 8 };
+  static constexpr std::size_t OccurrenceSize{ 8 };
+  static constexpr std::size_t ValueSize{ 8 };
+  static constexpr std::size_t ArgvEntrySize{ 12 };
+
+  explicit SerializedLayout( const SerializedHeader& h )
+    : options{ sizeof( SerializedHeader ) }
+    , occurrences{ options + h.numOptions * OptionSize }
+    , values{ occurrences + h.numOccurrences * OccurrenceSize }
+    , argvEntries{ values + h.numValues * ValueSize }
+    , strings{ argvEntries + h.numArgvEntries * ArgvEntrySize }
+    , subcommand{ strings + h.stringsSize }
+    , size{ subcommand + h.subcommandSize } {}
+
+  std::size_t options;
+  std::size_t occurrences;
+  std::size_t values;
+  std::size_t argvEntries;
+  std::size_t strings;
+  std::size_t subcommand;
+  std::size_t size; //!< Of the whole blob
+};
+
+
+inline void storeUint32( char* p, std::uint32_t value )
+{
+  std::memcpy( p, &value, sizeof( value ) );
+}
+
+
+inline std::uint32_t loadUint32( const char* p )
+{
+  std::uint32_t value;
+  std::memcpy( &value, p, sizeof( value ) );
+  return value;
+}
+
+
+/** \brief Serialize \a parsed into a compact, relocatable blob, see
+           SerializedHeader for the layout and SerializedOptions to read it.
+    \throw std::runtime_error if there are more than 2^32 - 1 of anything.
+
+    Keys are stored as their bytes so must be trivially copyable, e.g. an enum.
+ */
+template< class Key, class Hash, class String, class Allocator >
+std::vector<char> serialize( const BasicParsedOptions<Key, Hash, String, Allocator>& parsed )
+{
+  static_assert( std::is_trivially_copyable_v<Key>, "Keys are serialized as their bytes" );
+  using Layout = SerializedLayout<Key>;
+
+  std::size_t numOptions{ 0 };
+  std::size_t numOccurrences{ 0 };
+  std::size_t numValues{ 1 + parsed.trailingValues.size() };
+  std::size_t stringsSize{ std::string_view{ parsed.executable }.size() };
+  for ( const auto& value : parsed.trailingValues )
+  {
+    stringsSize += std::string_view{ value }.size();
+  }
+  for ( const auto& [ key, option ] : parsed.optionsByKey )
+  {
+    ++numOptions;
+    numOccurrences += option.occurrences.size();
+    for ( const auto& occurrence : option.occurrences )
+    {
+      numValues += occurrence.values.size();
+      for ( const auto& value : occurrence.values )
+      {
+        stringsSize += std::string_view{ value }.size();
+      }
+    }
+  }
+
+  std::vector<char> subcommand;
+  if ( parsed.subcommand )
+  {
+    subcommand = serialize( *parsed.subcommand );
+  }
+
+  constexpr std::size_t Max{ std::numeric_limits<std::uint32_t>::max() };
+  if ( ( numOccurrences > Max ) || ( numValues > Max ) || ( stringsSize > Max )
+    || ( parsed.optionsByArgvPosition.size() > Max ) || ( subcommand.size() > Max ) )
+  {
+    throw std::runtime_error( "Parsed options too large to serialize" );
+  }
+
+  const SerializedHeader Header{ SerializedMagic
+                               , SerializedVersion
+                               , static_cast<std::uint32_t>( sizeof( Key ) )
+                               , static_cast<std::uint32_t>( numOptions )
+                               , static_cast<std::uint32_t>( numOccurrences )
+                               , static_cast<std::uint32_t>( numValues )
+                               , static_cast<std::uint32_t>( parsed.trailingValues.size() )
+                               , static_cast<std::uint32_t>( parsed.optionsByArgvPosition.size() )
+                               , static_cast<std::uint32_t>( stringsSize )
+                               , static_cast<std::uint32_t>( subcommand.size() ) };
+  const Layout L{ Header };
+
+  std::vector<char> blob( L.size );
+  char* const out{ blob.data() };
+  std::memcpy( out, &Header, sizeof( Header ) );
+
+  std::uint32_t nextValue{ 0 };
+  std::uint32_t nextString{ 0 };
+  const auto addValue = [ & ]( std::string_view value )
+  {
+    char* const v{ out + L.values + nextValue++ * Layout::ValueSize };
+    storeUint32( v, nextString );
+    storeUint32( v + 4, static_cast<std::uint32_t>( value.size() ) );
+    std::memcpy( out + L.strings + nextString, value.data(), value.size() );
+    nextString += static_cast<std::uint32_t>( value.size() );
+  };
+
+  addValue( parsed.executable );
+  for ( const auto& value : parsed.trailingValues )
+  {
+    addValue( value );
+  }
+
+  std::unordered_map<Key, std::uint32_t, Hash> optionIndices;
+  std::uint32_t nextOption{ 0 };
+  std::uint32_t nextOccurrence{ 0 };
+  for ( const auto& [ key, option ] : parsed.optionsByKey )
+  {
+    char* const o{ out + L.options + nextOption * Layout::OptionSize };
+    std::memcpy( o, &key, sizeof( Key ) );
+    storeUint32( o + Layout::KeySize, nextOccurrence );
+    storeUint32( o + Layout::KeySize + 4, static_cast<std::uint32_t>( option.occurrences.size() ) );
+    for ( const auto& occurrence : option.occurrences )
+    {
+      char* const c{ out + L.occurrences + nextOccurrence++ * Layout::OccurrenceSize };
+      storeUint32( c, nextValue );
+      storeUint32( c + 4, static_cast<std::uint32_t>( occurrence.values.size() ) );
+      for ( const auto& value : occurrence.values )
+      {
+        addValue( value );
+      }
+    }
+    if ( !parsed.optionsByArgvPosition.empty() )
+    {
+      optionIndices.emplace( key, nextOption );
+    }
+    ++nextOption;
+  }
+
+  char* a{ out + L.argvEntries };
+  for ( const auto& entry : parsed.optionsByArgvPosition )
+  {
+    storeUint32( a, static_cast<std::uint32_t>( entry.positionIndex ) );
+    storeUint32( a + 4, optionIndices.at( entry.key ) );
+    storeUint32( a + 8, static_cast<std::uint32_t>( entry.occurrenceIndex ) );
+    a += Layout::ArgvEntrySize;
+  }
+
+  std::memcpy( out + L.subcommand, subcommand.data(), subcommand.size() );
+  return blob;
+}
+
+
+/** \brief A zero copy view of a blob written by serialize.
+
+    The blob is checked once on construction, after which every lookup reads
+    straight from it and every string is a view into it, so it must outlive
+    this and anything filled in by viewInto. It needs no particular alignment,
+    so a blob mapped from a memfd (see writeMemfd) or read into any buffer will
+    do.
+
+    Lookups by key walk the options, use viewInto for many lookups of a result
+    with many options.
+ */
+template< class Key >
+class SerializedOptions
+{
+public:
+  /** \throw std::runtime_error if the \a size bytes at \a data are not a valid
+             blob for this Key type.
+   */
+  SerializedOptions( const char* data, std::size_t size );
+
+  std::string_view getExecutable() const { return value( 0 ); }
+
+  /** \brief As ParsedOptions::isPresent. */
+  bool isPresent( const Key& key ) const { return findOption( key ) != header.numOptions; }
+
+  /** \brief As ParsedOptions::getLatestValue, but a view into the blob. */
+  std::string_view getLatestValue( const Key& key ) const;
+
+  /** \brief The result of the subcommand invoked, as
+             ParsedOptions::subcommand, if there was one.
+   */
+  std::optional<SerializedOptions> getSubcommand() const;
+
+  /** \brief Rebuild the parse result in \a parsed, a ParsedOptionsView or
+             pmr equivalent, as it was serialized.
+      \throw std::runtime_error if a key is not one of those of \a options
+             or a subcommand is not one of theirs.
+
+      No string is copied, and \a parsed reuses its storage as with
+      Options::parseInto, so this costs no allocations once warmed up. The
+      \a options give the slots for OptionHandle lookups so should be those
+      the result was originally parsed against, and the subcommand result
+      is rebuilt against their subcommand of that name.
+   */
+  template< class Schema, class Hash, class Allocator >
+  void viewInto( const Schema& options, BasicParsedOptions<Key, Hash, std::string_view, Allocator>& parsed ) const;
+
+private:
+  using Layout = SerializedLayout<Key>;
+
+  Key keyAt( std::uint32_t option ) const
+  {
+    Key key;
+    std::memcpy( &key, data + layout.options + option * Layout::OptionSize, sizeof( Key ) );
+    return key;
+  }
+
+  // The field at \a offset of element \a i of the section at \a section.
+  std::uint32_t field( std::size_t section, std::size_t stride, std::uint32_t i, std::size_t offset ) const
+  {
+    return loadUint32( data + section + i * stride + offset );
+  }
+
+  std::string_view value( std::uint32_t i ) const
+  {
+    return { data + layout.strings + field( layout.values, Layout::ValueSize, i, 0 )
+           , field( layout.values, Layout::ValueSize, i, 4 ) };
+  }
+
+  // The index of the option for \a key, or numOptions.
+  std::uint32_t findOption( const Key& key ) const;
+
+  // The header if there is room for one, otherwise all zero.
+  static SerializedHeader readHeader( const char* data, std::size_t size )
+  {
+    SerializedHeader h{};
+    if ( size >= sizeof( h ) )
+    {
+      std::memcpy( &h, data, sizeof( h ) );
+    }
+    return h;
+  }
+
+  const char* data;
+  SerializedHeader header;
+  Layout layout;
+};
+
+
+template< class Key >
+SerializedOptions<Key>::SerializedOptions( const char* d, std::size_t size )
+  : data{ d }
+  , header{ readHeader( d, size ) }
+  , layout{ header }
+{
+  static_assert( std::is_trivially_copyable_v<Key>, "Keys are serialized as their bytes" );
+
+  if ( size < sizeof( SerializedHeader ) )
+  {
+    throw std::runtime_error( "Serialized options truncated" );
+  }
+  if ( header.magic != SerializedMagic )
+  {
+    throw std::runtime_error( "Not serialized options" );
+  }
+  if ( header.version != SerializedVersion )
+  {
+    throw std::runtime_error( "Unsupported serialized options version " + std::to_string( header.version ) );
+  }
+  if ( header.keySize != sizeof( Key ) )
+  {
+    throw std::runtime_error( "Serialized options have a different key type" );
+  }
+  if ( layout.size != size )
+  {
+    throw std::runtime_error( "Serialized options truncated" );
+  }
+
+  // Check every index and offset once so that lookups need not.
+  const auto check = []( bool valid )
+  {
+    if ( !valid )
+    {
+      throw std::runtime_error( "Serialized options corrupt" );
+    }
+  };
+  check( header.numValues >= std::uint64_t{ 1 } + header.numTrailingValues );
+  for ( std::uint32_t o = 0; o < header.numOptions; ++o )
+  {
+    check( std::uint64_t{ field( layout.options, Layout::OptionSize, o, Layout::KeySize ) }
+         + field( layout.options, Layout::OptionSize, o, Layout::KeySize + 4 ) <= header.numOccurrences );
+  }
+  for ( std::uint32_t c = 0; c < header.numOccurrences; ++c )
+  {
+    check( std::uint64_t{ field( layout.occurrences, Layout::OccurrenceSize, c, 0 ) }
+         + field( layout.occurrences, Layout::OccurrenceSize, c, 4 ) <= header.numValues );
+  }
+  for ( std::uint32_t v = 0; v < header.numValues; ++v )
+  {
+    check( std::uint64_t{ field( layout.values, Layout::ValueSize, v, 0 ) }
+         + field( layout.values, Layout::ValueSize, v, 4 ) <= header.stringsSize );
+  }
+  for ( std::uint32_t a = 0; a < header.numArgvEntries; ++a )
+  {
+    const std::uint32_t Option{ field( layout.argvEntries, Layout::ArgvEntrySize, a, 4 ) };
+    check( Option < header.numOptions );
+    check( field( layout.argvEntries, Layout::ArgvEntrySize, a, 8 )
+         < field( layout.options, Layout::OptionSize, Option, Layout::KeySize + 4 ) );
+  }
+
+  // As is a subcommand's blob, in turn.
+  getSubcommand();
+}
+
+
+template< class Key >
+std::uint32_t SerializedOptions<Key>::findOption( const Key& key ) const
+{
+  for ( std::uint32_t o = 0; o < header.numOptions; ++o )
+  {
+    if ( keyAt( o ) == key )
+    {
+      return o;
+    }
+  }
+  return header.numOptions;
+}
+
+
+template< class Key >
+std::string_view SerializedOptions<Key>::getLatestValue( const Key& key ) const
+{
+  const std::uint32_t O{ findOption( key ) };
+  if ( O == header.numOptions )
+  {
+    return {};
+  }
+  const std::uint32_t NumOccurrences{ field( layout.options, Layout::OptionSize, O, Layout::KeySize + 4 ) };
+  if ( NumOccurrences == 0 )
+  {
+    return {};
+  }
+  const std::uint32_t C{ field( layout.options, Layout::OptionSize, O, Layout::KeySize ) + NumOccurrences - 1 };
+  const std::uint32_t NumValues{ field( layout.occurrences, Layout::OccurrenceSize, C, 4 ) };
+  if ( NumValues == 0 )
+  {
+    return {};
+  }
+  return value( field( layout.occurrences, Layout::OccurrenceSize, C, 0 ) + NumValues - 1 );
+}
+
+
+template< class Key >
+auto SerializedOptions<Key>::getSubcommand() const -> std::optional<SerializedOptions>
+{
+  if ( header.subcommandSize == 0 )
+  {
+    return std::nullopt;
+  }
+  return SerializedOptions{ data + layout.subcommand, header.subcommandSize };
+}
+
+
+template< class Key >
+template< class Schema, class Hash, class Allocator >
+void SerializedOptions<Key>::viewInto( const Schema& options
+                                     , BasicParsedOptions<Key, Hash, std::string_view, Allocator>& parsed ) const
+{
+  parsed.clear();
+  parsed.executable = getExecutable();
+  for ( std::uint32_t v = 1; v <= header.numTrailingValues; ++v )
+  {
+    parsed.addValue( parsed.trailingValues, value( v ) );
+  }
+
+  for ( std::uint32_t o = 0; o < header.numOptions; ++o )
+  {
+    const Key K{ keyAt( o ) };
+    auto& option{ parsed.findOrAddOption( K, options.handle( K ).slot, options.size() ) };
+    const std::uint32_t FirstOccurrence{ field( layout.options, Layout::OptionSize, o, Layout::KeySize ) };
+    const std::uint32_t NumOccurrences{ field( layout.options, Layout::OptionSize, o, Layout::KeySize + 4 ) };
+    for ( std::uint32_t c = FirstOccurrence; c < FirstOccurrence + NumOccurrences; ++c )
+    {
+      auto& values{ parsed.addOccurrence( option ).values };
+      const std::uint32_t FirstValue{ field( layout.occurrences, Layout::OccurrenceSize, c, 0 ) };
+      const std::uint32_t NumValues{ field( layout.occurrences, Layout::OccurrenceSize, c, 4 ) };
+      for ( std::uint32_t v = FirstValue; v < FirstValue + NumValues; ++v )
+      {
+        parsed.addValue( values, value( v ) );
+      }
+    }
+  }
+
+  for ( std::uint32_t a = 0; a < header.numArgvEntries; ++a )
+  {
+    parsed.optionsByArgvPosition.emplace_back( field( layout.argvEntries, Layout::ArgvEntrySize, a, 0 )
+                                             , keyAt( field( layout.argvEntries, Layout::ArgvEntrySize, a, 4 ) )
+                                             , field( layout.argvEntries, Layout::ArgvEntrySize, a, 8 ) );
+  }
+
+  if ( const auto subcommand{ getSubcommand() } )
+  {
+    const Schema* subcommandOptions{ nullptr };
+    if constexpr ( supportsSubcommands<Schema> )
+    {
+      subcommandOptions = options.findSubcommand( subcommand->getExecutable() );
+    }
+    if ( !subcommandOptions )
+    {
+      throw std::runtime_error( "Unknown serialized subcommand " + std::string{ subcommand->getExecutable() } );
+    }
+    subcommand->viewInto( *subcommandOptions, parsed.addSubcommand() );
+  }
+}
+
+
+/** \brief Put \a blob in a new sealed memfd for another process to map, see
+           MappedFile( int, Mode ).
+    \return The descriptor. It is inherited across fork and exec, so pass its
+            number on to the child, and it can no longer be written to, so
+            the child can trust that it will not change under its mapping.
+    \throw std::runtime_error if it cannot be created, written or sealed.
+ */
+inline int writeMemfd( const std::vector<char>& blob, const char* name = "lbOptions" )
+{
+  const int fd{ ::memfd_create( name, MFD_ALLOW_SEALING ) };
+  if ( fd < 0 )
+  {
+    throw std::runtime_error( std::string{ "Could not create memfd: " } + std::strerror( errno ) );
+  }
+
+  const char* next{ blob.data() };
+  std::size_t remaining{ blob.size() };
+  while ( remaining > 0 )
+  {
+    const ssize_t Written{ ::write( fd, next, remaining ) };
+    if ( Written < 0 )
+    {
+      if ( errno == EINTR )
+      {
+        continue;
+      }
+      const int error{ errno };
+      ::close( fd );
+      throw std::runtime_error( std::string{ "Could not write memfd: " } + std::strerror( error ) );
+    }
+    next += Written;
+    remaining -= static_cast<std::size_t>( Written );
+  }
+
+  if ( ::fcntl( fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL ) != 0 )
+  {
+    const int error{ errno };
+    ::close( fd );
+    throw std::runtime_error( std::string{ "Could not seal memfd: " } + std::strerror( error ) );
+  }
+  return fd;
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_SERIALIZE_H
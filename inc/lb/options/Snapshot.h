@@ -0,0 +1,762 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_SNAPSHOT_H
+#define LIB_LB_OPTIONS_SNAPSHOT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <lb/options/MappedFile.h>
+#include <lb/options/OptionHandle.h>
+#include <lb/options/Options.h>
+#include <lb/options/ParsedOptions.h>
+#include <lb/options/Parsing.h>
+#include <lb/options/PerfectHash.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief A string in a snapshot, stored as its offset from this object so it
+           reads the same wherever the snapshot is loaded or mapped.
+ */
+struct SnapshotString
+{
+  std::int32_t offset;
+  std::uint32_t length;
+
+  std::string_view view() const { return { reinterpret_cast<const char*>( this ) + offset, length }; }
+  operator std::string_view() const { return view(); }
+  bool empty() const { return length == 0; }
+};
+
+
+/** \brief An array in a snapshot, stored as for SnapshotString. */
+template< class T >
+struct SnapshotArray
+{
+  std::int32_t offset;
+  std::uint32_t count;
+
+  const T* begin() const { return reinterpret_cast<const T*>( reinterpret_cast<const char*>( this ) + offset ); }
+  const T* end() const { return begin() + count; }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const T& operator[]( std::size_t i ) const { return begin()[i]; }
+};
+
+
+/** \brief The snapshot equivalent of OptionDefinition, read in place. */
+struct SnapshotOptionDefinition
+{
+  char s; //!< short version
+  SnapshotString l; //!< long version
+
+  std::int32_t minNumValues;
+  std::int32_t maxNumValues;
+
+  SnapshotString description;
+  SnapshotArray< SnapshotString > defaultValues;
+  SnapshotString environmentVariable;
+};
+
+
+/** \brief Aggregates the key and the snapshot option definition. */
+template< class Key >
+struct SnapshotKeyedOptionDefinition
+{
+  Key key;
+  SnapshotOptionDefinition option;
+};
+
+
+/** \brief An option bound to an environment variable. */
+struct SnapshotBinding
+{
+  SnapshotString variable;
+  std::uint32_t option;
+};
+
+
+/** \brief The start of an Options snapshot written by writeSnapshot.
+
+    Everything is in native byte order and layout and the tables are those of
+    Options itself: definitions, the short flag table, perfect hashes over the
+    long flags, keys and environment variables, the long flags in order (for
+    abbreviations) and the options with defaults. An empty perfect hash means
+    none could be built, lookups then fall back on the ordered long flags or a
+    scan.
+ */
+template< class Key >
+struct SnapshotHeader
+{
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t keySize;
+  std::uint32_t definitionSize;
+  std::uint32_t size; //!< Of the whole snapshot
+
+  std::uint8_t allowTrailingValues;
+  std::uint8_t allowAbbreviations;
+  std::uint8_t expandResponseFiles;
+
+  std::uint64_t longHashSeed;
+  std::uint64_t environmentHashSeed;
+
+  SnapshotArray< SnapshotKeyedOptionDefinition<Key> > definitions;
+  SnapshotArray< std::uint32_t > byShort; //!< 256 entries
+  SnapshotArray< std::uint32_t > longDisplacements;
+  SnapshotArray< std::uint32_t > longSlots;
+  SnapshotArray< std::uint32_t > sortedLong; //!< Options with a long flag in flag order
+  SnapshotArray< std::uint32_t > keyDisplacements;
+  SnapshotArray< std::uint32_t > keySlots;
+  SnapshotArray< std::uint32_t > haveDefaults;
+  SnapshotArray< SnapshotBinding > bindings;
+  SnapshotArray< std::uint32_t > environmentDisplacements;
+  SnapshotArray< std::uint32_t > environmentSlots;
+};
+
+constexpr std::uint32_t SnapshotMagic{ 0x534f424c }; // LBOS
+constexpr std::uint32_t SnapshotVersion{ 1 };
+constexpr std::uint32_t SnapshotNone{ ~std::uint32_t{ 0 } };
+
+/** \brief The alignment a snapshot must be loaded at. */
+constexpr std::size_t SnapshotAlignment{ 8 };
+
+
+/** \brief Builds a snapshot, every position being an offset into it as it
+           may move while it grows.
+ */
+class SnapshotWriter
+{
+public:
+  /** \brief Room for \a count zeroed T's, aligned for T.
+      \return Their offset.
+   */
+  template< class T >
+  std::size_t allocate( std::size_t count )
+  {
+    const std::size_t offset{ ( blob.size() + alignof( T ) - 1 ) / alignof( T ) * alignof( T ) };
+    blob.resize( offset + count * sizeof( T ) );
+    return offset;
+  }
+
+  /** \brief As allocate, pointing the SnapshotArray at \a field to them. */
+  template< class T >
+  std::size_t allocateArray( std::size_t field, std::size_t count )
+  {
+    const std::size_t offset{ allocate<T>( count ) };
+    point( field, offset, count );
+    return offset;
+  }
+
+  /** \brief Copy in \a s and point the SnapshotString at \a field to it. */
+  void addString( std::size_t field, std::string_view s )
+  {
+    const std::size_t offset{ allocate<char>( s.size() ) };
+    std::memcpy( blob.data() + offset, s.data(), s.size() );
+    point( field, offset, s.size() );
+  }
+
+  template< class T >
+  T& at( std::size_t offset ) { return *reinterpret_cast<T*>( blob.data() + offset ); }
+
+  void fill( std::size_t offset, const std::vector< std::uint32_t >& values )
+  {
+    std::memcpy( blob.data() + offset, values.data(), values.size() * sizeof( std::uint32_t ) );
+  }
+
+  std::size_t size() const { return blob.size(); }
+
+  std::vector<char> release() { return std::move( blob ); }
+
+private:
+  std::vector<char> blob;
+
+  void point( std::size_t field, std::size_t target, std::size_t count )
+  {
+    const auto offset{ static_cast<std::int32_t>( static_cast<std::int64_t>( target ) - static_cast<std::int64_t>( field ) ) };
+    const auto size{ static_cast<std::uint32_t>( count ) };
+    std::memcpy( blob.data() + field, &offset, sizeof( offset ) );
+    std::memcpy( blob.data() + field + sizeof( offset ), &size, sizeof( size ) );
+  }
+};
+
+
+/** \brief Write a snapshot of \a options, fully validated and indexed, for
+           OptionsSnapshot to use as is.
+    \throw std::runtime_error if the snapshot would exceed 2GB.
+
+    The snapshot is for the build that wrote it, keys are stored as their
+    bytes and looked up through Hash, so Key must be trivially copyable, e.g.
+    an enum, and Hash must not vary between runs.
+ */
+template< class Key, class Hash >
+std::vector<char> writeSnapshot( const Options<Key, Hash>& options )
+{
+  static_assert( std::is_trivially_copyable_v<Key> && std::is_standard_layout_v<Key>
+               , "Snapshot keys are stored as their bytes." );
+  static_assert( alignof( Key ) <= SnapshotAlignment, "Snapshot keys must not be over aligned." );
+
+  using Header = SnapshotHeader<Key>;
+  using Definition = SnapshotKeyedOptionDefinition<Key>;
+  constexpr std::size_t Option{ offsetof( Definition, option ) };
+
+  const auto& config{ options.getConfiguration() };
+  const std::size_t n{ options.size() };
+
+  SnapshotWriter writer;
+  writer.allocate<Header>( 1 );
+  {
+    auto& header{ writer.at<Header>( 0 ) };
+    header.magic = SnapshotMagic;
+    header.version = SnapshotVersion;
+    header.keySize = sizeof( Key );
+    header.definitionSize = sizeof( Definition );
+    header.allowTrailingValues = config.allowTrailingValues;
+    header.allowAbbreviations = config.allowAbbreviations;
+    header.expandResponseFiles = config.expandResponseFiles;
+  }
+
+  std::vector< std::uint32_t > haveDefaults;
+  std::vector< std::uint32_t > withLong;
+  std::vector< std::string > variables( n );
+  std::vector< std::uint32_t > bound;
+
+  const std::size_t D{ writer.allocateArray<Definition>( offsetof( Header, definitions ), n ) };
+  for ( std::size_t i = 0; i < n; ++i )
+  {
+    const auto& a{ options.definitionAt( i ) };
+    const std::size_t A{ D + i * sizeof( Definition ) };
+    {
+      auto& definition{ writer.at<Definition>( A ) };
+      definition.key = a.key;
+      definition.option.s = a.option.s;
+      definition.option.minNumValues = a.option.minNumValues;
+      definition.option.maxNumValues = a.option.maxNumValues;
+    }
+    writer.addString( A + Option + offsetof( SnapshotOptionDefinition, l ), a.option.l );
+    writer.addString( A + Option + offsetof( SnapshotOptionDefinition, description ), a.option.description );
+    writer.addString( A + Option + offsetof( SnapshotOptionDefinition, environmentVariable ), a.option.environmentVariable );
+
+    const std::size_t V{ writer.allocateArray<SnapshotString>( A + Option + offsetof( SnapshotOptionDefinition, defaultValues )
+                                                             , a.option.defaultValues.size() ) };
+    for ( std::size_t v = 0; v < a.option.defaultValues.size(); ++v )
+    {
+      writer.addString( V + v * sizeof( SnapshotString ), a.option.defaultValues[v] );
+    }
+
+    if ( !a.option.defaultValues.empty() )
+    {
+      haveDefaults.push_back( static_cast<std::uint32_t>( i ) );
+    }
+    if ( !a.option.l.empty() )
+    {
+      withLong.push_back( static_cast<std::uint32_t>( i ) );
+    }
+    variables[i] = boundEnvironmentVariable( config.environmentPrefix, a.option );
+    if ( !variables[i].empty() )
+    {
+      bound.push_back( static_cast<std::uint32_t>( i ) );
+    }
+  }
+
+  std::vector< std::uint32_t > byShort( 256, SnapshotNone );
+  for ( std::size_t c = 0; c < byShort.size(); ++c )
+  {
+    if ( const auto* const a{ options.findShort( static_cast<char>( c ) ) } )
+    {
+      byShort[c] = static_cast<std::uint32_t>( options.slotOf( *a ) );
+    }
+  }
+  writer.fill( writer.allocateArray<std::uint32_t>( offsetof( Header, byShort ), byShort.size() ), byShort );
+
+  const auto store = [&writer]( std::size_t displacementsField
+                              , std::size_t slotsField
+                              , const MinimalPerfectHash& hash )
+  {
+    writer.fill( writer.allocateArray<std::uint32_t>( displacementsField, hash.getDisplacements().size() )
+               , hash.getDisplacements() );
+    writer.fill( writer.allocateArray<std::uint32_t>( slotsField, hash.getSlots().size() )
+               , hash.getSlots() );
+  };
+
+  // Seeded as Options does, the flags and variables are distinct so only a
+  // very unlucky seed fails.
+  std::vector< std::uint64_t > hashes;
+  MinimalPerfectHash longHash;
+  std::uint64_t longHashSeed{ 0 };
+  do
+  {
+    ++longHashSeed;
+    hashes.clear();
+    for ( const auto i : withLong )
+    {
+      hashes.push_back( hashString( options.definitionAt( i ).option.l, longHashSeed ) );
+    }
+  } while ( !longHash.build( hashes, withLong ) && ( longHashSeed < 16 ) );
+  writer.at<Header>( 0 ).longHashSeed = longHashSeed;
+  store( offsetof( Header, longDisplacements ), offsetof( Header, longSlots ), longHash );
+
+  std::sort( withLong.begin(), withLong.end(), [&options]( std::uint32_t a, std::uint32_t b )
+  {
+    return options.definitionAt( a ).option.l < options.definitionAt( b ).option.l;
+  } );
+  writer.fill( writer.allocateArray<std::uint32_t>( offsetof( Header, sortedLong ), withLong.size() ), withLong );
+
+  hashes.clear();
+  for ( std::size_t i = 0; i < n; ++i )
+  {
+    hashes.push_back( Hash{}( options.definitionAt( i ).key ) );
+  }
+  MinimalPerfectHash keyHash;
+  keyHash.build( hashes );
+  store( offsetof( Header, keyDisplacements ), offsetof( Header, keySlots ), keyHash );
+
+  writer.fill( writer.allocateArray<std::uint32_t>( offsetof( Header, haveDefaults ), haveDefaults.size() ), haveDefaults );
+
+  const std::size_t B{ writer.allocateArray<SnapshotBinding>( offsetof( Header, bindings ), bound.size() ) };
+  for ( std::size_t b = 0; b < bound.size(); ++b )
+  {
+    writer.at<SnapshotBinding>( B + b * sizeof( SnapshotBinding ) ).option = bound[b];
+    writer.addString( B + b * sizeof( SnapshotBinding ) + offsetof( SnapshotBinding, variable ), variables[ bound[b] ] );
+  }
+
+  MinimalPerfectHash environmentHash;
+  std::uint64_t environmentHashSeed{ 0 };
+  if ( !bound.empty() )
+  {
+    do
+    {
+      ++environmentHashSeed;
+      hashes.clear();
+      for ( const auto i : bound )
+      {
+        hashes.push_back( hashString( variables[i], environmentHashSeed ) );
+      }
+    } while ( !environmentHash.build( hashes ) && ( environmentHashSeed < 16 ) );
+  }
+  writer.at<Header>( 0 ).environmentHashSeed = environmentHashSeed;
+  store( offsetof( Header, environmentDisplacements ), offsetof( Header, environmentSlots ), environmentHash );
+
+  if ( writer.size() > static_cast<std::size_t>( std::numeric_limits<std::int32_t>::max() ) )
+  {
+    throw std::runtime_error( "Cannot snapshot options, too large." );
+  }
+  writer.at<Header>( 0 ).size = static_cast<std::uint32_t>( writer.size() );
+  return writer.release();
+}
+
+
+/** \brief An option table used straight from a snapshot written by
+           writeSnapshot, with no validation or indexing at startup.
+
+    Loading checks the header and the bounds of each table, a constant cost
+    however many options there are, and lookups then read the snapshot in
+    place. It parses exactly as the Options it was taken from would, defaults,
+    environment bindings and abbreviations included, and results are
+    interchangeable with that instance's (same slots, so the same handles).
+
+    The snapshot can be memory-mapped from a file or embedded in the
+    executable, e.g. with .incbin into a section aligned to SnapshotAlignment.
+    Its contents beyond the header are trusted so it must come from
+    writeSnapshot in the same build.
+
+    All const methods are safe to call from several threads at once.
+ */
+template< class Key, class Hash = std::hash<Key> >
+class OptionsSnapshot
+{
+public:
+  struct Configuration
+  {
+    bool allowTrailingValues;
+    bool allowAbbreviations;
+    bool expandResponseFiles;
+  };
+
+  using Definition = SnapshotKeyedOptionDefinition<Key>;
+
+  /** \brief Use the snapshot at \a data, which must outlive this.
+      \throw std::runtime_error if it is not a snapshot for this Key, is
+             truncated or is not aligned to SnapshotAlignment.
+   */
+  OptionsSnapshot( const char* data, std::size_t size );
+
+  /** \brief Map the snapshot in the file at \a path and use it from there.
+      \throw std::runtime_error if the file cannot be mapped or as above.
+   */
+  explicit OptionsSnapshot( const std::string& path );
+
+  /** \brief Parse the given options, see Options::parse. */
+  ParsedOptions<Key, Hash> parse( int argc, char** argv ) const;
+
+  /** \brief Parse the given options without copying, see Options::parseView.
+             Default values refer into the snapshot.
+   */
+  ParsedOptionsView<Key, Hash> parseView( int argc, char** argv ) const;
+
+  /** \brief Parse the given options into an existing result, see Options::parseInto. */
+  template< class String, class Allocator >
+  void parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed, int argc, char** argv ) const;
+
+  /** \brief Parse with a config file, see Options::parse. */
+  ParsedOptions<Key, Hash> parse( int argc, char** argv, std::string_view configPath ) const;
+
+  /** \brief Parse with a config file into an existing result, see Options::parseInto. */
+  template< class String, class Allocator >
+  void parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                , int argc
+                , char** argv
+                , std::string_view configPath ) const;
+
+  /** \brief The configuration of the Options the snapshot was taken from. */
+  const Configuration& getConfiguration() const { return config; }
+
+  /** \brief Look up the definition for the option given by \a key.
+      \throw std::runtime_error if there is no option for \a key.
+   */
+  const SnapshotOptionDefinition& getDefinition( Key key ) const;
+
+  /** \brief A handle for fast lookups of \a key, see Options::handle. */
+  OptionHandle handle( Key key ) const;
+
+  /** \brief The number of option definitions. */
+  std::size_t size() const { return header->definitions.size(); }
+
+  /** \brief The position of \a definition, which must be one of ours. */
+  std::size_t slotOf( const Definition& definition ) const { return &definition - header->definitions.begin(); }
+
+  /** \brief Look up a definition by flag, see Options::findShort. */
+  const Definition* findShort( char s ) const;
+  const Definition* findLong( std::string_view l ) const;
+
+  /** \brief Call \a f with each definition that has default values. */
+  template< class F >
+  void forEachDefault( F f ) const;
+
+  /** \brief See Options::forEachFromEnvironment. */
+  template< class F >
+  void forEachFromEnvironment( F f ) const;
+
+private:
+  std::shared_ptr<const MappedFile> file;
+  const SnapshotHeader<Key>* header;
+  Configuration config;
+
+  void load( const char* data, std::size_t size );
+
+  // The definition index of \a key, or SnapshotNone.
+  std::uint32_t findKey( const Key& key ) const;
+};
+
+
+template< class Key, class Hash >
+OptionsSnapshot<Key, Hash>::OptionsSnapshot( const char* data, std::size_t size )
+{
+  load( data, size );
+}
+
+
+template< class Key, class Hash >
+OptionsSnapshot<Key, Hash>::OptionsSnapshot( const std::string& path )
+  : file{ std::make_shared<const MappedFile>( path, MappedFile::Mode::eReadOnly ) }
+{
+  load( file->data(), file->size() );
+}
+
+
+template< class Key, class Hash >
+void OptionsSnapshot<Key, Hash>::load( const char* data, std::size_t size )
+{
+  using Header = SnapshotHeader<Key>;
+
+  if ( reinterpret_cast<std::uintptr_t>( data ) % SnapshotAlignment != 0 )
+  {
+    throw std::runtime_error( "Invalid options snapshot, misaligned." );
+  }
+  if ( size < sizeof( Header ) )
+  {
+    throw std::runtime_error( "Invalid options snapshot, truncated header." );
+  }
+  header = reinterpret_cast<const Header*>( data );
+  if ( ( header->magic != SnapshotMagic ) || ( header->version != SnapshotVersion ) )
+  {
+    throw std::runtime_error( "Invalid options snapshot, unknown format." );
+  }
+  if ( ( header->keySize != sizeof( Key ) ) || ( header->definitionSize != sizeof( Definition ) ) )
+  {
+    throw std::runtime_error( "Invalid options snapshot, written for a different key." );
+  }
+  if ( header->size > size )
+  {
+    throw std::runtime_error( "Invalid options snapshot, truncated." );
+  }
+
+  const auto inBounds = [data, size = header->size]( const auto& array )
+  {
+    const char* const first{ reinterpret_cast<const char*>( array.begin() ) };
+    const char* const last { reinterpret_cast<const char*>( array.end() ) };
+    return ( first >= data ) && ( last >= first ) && ( last <= data + size );
+  };
+  if ( !inBounds( header->definitions ) || ( header->byShort.size() != 256 ) || !inBounds( header->byShort )
+    || !inBounds( header->longDisplacements ) || !inBounds( header->longSlots ) || !inBounds( header->sortedLong )
+    || !inBounds( header->keyDisplacements ) || !inBounds( header->keySlots ) || !inBounds( header->haveDefaults )
+    || !inBounds( header->bindings ) || !inBounds( header->environmentDisplacements )
+    || !inBounds( header->environmentSlots ) )
+  {
+    throw std::runtime_error( "Invalid options snapshot, table out of bounds." );
+  }
+
+  config = { header->allowTrailingValues != 0
+           , header->allowAbbreviations != 0
+           , header->expandResponseFiles != 0 };
+}
+
+
+template< class Key, class Hash >
+ParsedOptions<Key, Hash> OptionsSnapshot<Key, Hash>::parse( int argc, char** argv ) const
+{
+  return parseArgv<ParsedOptions<Key, Hash>>( *this, config, argc, argv );
+}
+
+
+template< class Key, class Hash >
+ParsedOptionsView<Key, Hash> OptionsSnapshot<Key, Hash>::parseView( int argc, char** argv ) const
+{
+  return parseArgv<ParsedOptionsView<Key, Hash>>( *this, config, argc, argv );
+}
+
+
+template< class Key, class Hash >
+template< class String, class Allocator >
+void OptionsSnapshot<Key, Hash>::parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                                          , int argc
+                                          , char** argv ) const
+{
+  parseArgvInto( *this, config, argc, argv, parsed );
+}
+
+
+template< class Key, class Hash >
+ParsedOptions<Key, Hash> OptionsSnapshot<Key, Hash>::parse( int argc, char** argv, std::string_view configPath ) const
+{
+  ParsedOptions<Key, Hash> parsed;
+  parseInto( parsed, argc, argv, configPath );
+  return parsed;
+}
+
+
+template< class Key, class Hash >
+template< class String, class Allocator >
+void OptionsSnapshot<Key, Hash>::parseInto( BasicParsedOptions<Key, Hash, String, Allocator>& parsed
+                                          , int argc
+                                          , char** argv
+                                          , std::string_view configPath ) const
+{
+  parseArgumentsInto( *this, config, argv, argv + argc, parsed, configPath );
+}
+
+
+template< class Key, class Hash >
+auto OptionsSnapshot<Key, Hash>::findShort( char s ) const -> const Definition*
+{
+  const std::uint32_t S{ header->byShort[ static_cast<unsigned char>( s ) ] };
+  return S == SnapshotNone ? nullptr : &header->definitions[S];
+}
+
+
+template< class Key, class Hash >
+auto OptionsSnapshot<Key, Hash>::findLong( std::string_view l ) const -> const Definition*
+{
+  const auto& definitions{ header->definitions };
+  if ( !header->longSlots.empty() )
+  {
+    const std::uint32_t L{ header->longSlots[ perfectHashLookup( hashString( l, header->longHashSeed )
+                                                               , header->longDisplacements.begin()
+                                                               , header->longDisplacements.size()
+                                                               , header->longSlots.size() ) ] };
+    if ( definitions[L].option.l.view() == l )
+    {
+      return &definitions[L];
+    }
+    if ( !config.allowAbbreviations )
+    {
+      return nullptr;
+    }
+  }
+
+  // The first long flag not before l, which is l itself or the first that l
+  // is a prefix of if any is.
+  const auto& sorted{ header->sortedLong };
+  const auto* const L{ std::lower_bound( sorted.begin(), sorted.end(), l
+                                       , [&definitions]( std::uint32_t i, std::string_view l )
+                                         {
+                                           return definitions[i].option.l.view() < l;
+                                         } ) };
+  if ( ( L == sorted.end() ) || l.empty() )
+  {
+    return nullptr;
+  }
+  const std::string_view flag{ definitions[*L].option.l };
+  if ( flag == l )
+  {
+    return &definitions[*L];
+  }
+  if ( !config.allowAbbreviations || ( flag.substr( 0, l.size() ) != l ) )
+  {
+    return nullptr;
+  }
+  // Ambiguous if the next flag has the same prefix.
+  if ( ( L + 1 != sorted.end() ) && ( definitions[ L[1] ].option.l.view().substr( 0, l.size() ) == l ) )
+  {
+    return nullptr;
+  }
+  return &definitions[*L];
+}
+
+
+template< class Key, class Hash >
+template< class F >
+void OptionsSnapshot<Key, Hash>::forEachDefault( F f ) const
+{
+  for ( const auto i : header->haveDefaults )
+  {
+    f( header->definitions[i] );
+  }
+}
+
+
+template< class Key, class Hash >
+template< class F >
+void OptionsSnapshot<Key, Hash>::forEachFromEnvironment( F f ) const
+{
+  const auto& bindings{ header->bindings };
+  if ( bindings.empty() )
+  {
+    return;
+  }
+
+  forEachEnvironmentVariable( [this, &bindings, &f]( std::string_view variable, std::string_view value )
+  {
+    const auto& slots{ header->environmentSlots };
+    if ( !slots.empty() )
+    {
+      const auto& binding{ bindings[ slots[ perfectHashLookup( hashString( variable, header->environmentHashSeed )
+                                                             , header->environmentDisplacements.begin()
+                                                             , header->environmentDisplacements.size()
+                                                             , slots.size() ) ] ] };
+      if ( binding.variable.view() == variable )
+      {
+        f( header->definitions[ binding.option ], variable, value );
+      }
+      return;
+    }
+
+    // Only if no seed gave a perfect hash, which takes very bad luck.
+    for ( const auto& binding : bindings )
+    {
+      if ( binding.variable.view() == variable )
+      {
+        f( header->definitions[ binding.option ], variable, value );
+      }
+    }
+  } );
+}
+
+
+template< class Key, class Hash >
+std::uint32_t OptionsSnapshot<Key, Hash>::findKey( const Key& key ) const
+{
+  const auto& definitions{ header->definitions };
+  if ( !header->keySlots.empty() )
+  {
+    const std::uint32_t K{ header->keySlots[ perfectHashLookup( Hash{}( key )
+                                                              , header->keyDisplacements.begin()
+                                                              , header->keyDisplacements.size()
+                                                              , header->keySlots.size() ) ] };
+    return definitions[K].key == key ? K : SnapshotNone;
+  }
+
+  // Only if two keys have equal hashes.
+  for ( std::size_t i = 0; i < definitions.size(); ++i )
+  {
+    if ( definitions[i].key == key )
+    {
+      return static_cast<std::uint32_t>( i );
+    }
+  }
+  return SnapshotNone;
+}
+
+
+template< class Key, class Hash >
+OptionHandle OptionsSnapshot<Key, Hash>::handle( Key key ) const
+{
+  const std::uint32_t K{ findKey( key ) };
+  if ( K != SnapshotNone )
+  {
+    return { K };
+  }
+  throw std::runtime_error( "Option key not found" );
+}
+
+
+template< class Key, class Hash >
+const SnapshotOptionDefinition& OptionsSnapshot<Key, Hash>::getDefinition( Key key ) const
+{
+  const std::uint32_t K{ findKey( key ) };
+  if ( K != SnapshotNone )
+  {
+    return header->definitions[K].option;
+  }
+  throw std::runtime_error( "Option key not found" );
+}
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_SNAPSHOT_H
@@ -0,0 +1,136 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_THREADPOOL_H
+#define LIB_LB_OPTIONS_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief A fixed set of worker threads running tasks in submission order.
+
+    This is the minimal executor for parseBatch, anything callable with a
+    std::function<void()> that runs it at some point will do in its place.
+    Destruction waits for the tasks already submitted to finish. Tasks must
+    not throw.
+ */
+class ThreadPool
+{
+public:
+  /** \brief Start \a numThreads workers, at least one. */
+  explicit ThreadPool( std::size_t numThreads = std::thread::hardware_concurrency() )
+  {
+    if ( numThreads == 0 )
+    {
+      numThreads = 1;
+    }
+    workers.reserve( numThreads );
+    for ( std::size_t i = 0; i < numThreads; ++i )
+    {
+      workers.emplace_back( [ this ]{ work(); } );
+    }
+  }
+
+  ThreadPool( const ThreadPool& ) = delete;
+  ThreadPool& operator=( const ThreadPool& ) = delete;
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock{ mutex };
+      stopping = true;
+    }
+    wake.notify_all();
+    for ( auto& worker : workers )
+    {
+      worker.join();
+    }
+  }
+
+  /** \brief Queue \a task to run on one of the workers. */
+  void operator()( std::function<void()> task )
+  {
+    {
+      std::lock_guard<std::mutex> lock{ mutex };
+      tasks.push_back( std::move( task ) );
+    }
+    wake.notify_one();
+  }
+
+  /** \brief The number of worker threads. */
+  std::size_t size() const { return workers.size(); }
+
+private:
+  void work()
+  {
+    for ( ;; )
+    {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock{ mutex };
+        wake.wait( lock, [ this ]{ return stopping || !tasks.empty(); } );
+        if ( tasks.empty() )
+        {
+          return;
+        }
+        task = std::move( tasks.front() );
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque< std::function<void()> > tasks;
+  bool stopping{ false };
+
+  std::vector<std::thread> workers; // Last so the rest exists before they start
+};
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_THREADPOOL_H
@@ -0,0 +1,151 @@
+/*
+    This is free and unencumbered software released into the public domain.
+
+    Anyone is free to copy, modify, publish, use, compile, sell, or
+    distribute this software, either in source code form or as a compiled
+    binary, for any purpose, commercial or non-commercial, and by any
+    means.
+
+    In jurisdictions that recognize copyright laws, the author or authors
+    of this software dedicate any and all copyright interest in the
+    software to the public domain. We make this dedication for the benefit
+    of the public at large and to the detriment of our heirs and
+    successors. We intend this dedication to be an overt act of
+    relinquishment in perpetuity of all present and future rights to this
+    software under copyright law.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+    OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    For more information, please refer to <https://unlicense.org>
+*/
+
+#ifndef LIB_LB_OPTIONS_USAGE_H
+#define LIB_LB_OPTIONS_USAGE_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include <unistd.h>
+
+#include <lb/options/Options.h>
+#include <lb/options/print.h>
+
+
+namespace lb
+{
+
+
+namespace options
+{
+
+
+/** \brief The narrowest a description is wrapped at, however narrow the
+           terminal.
+ */
+constexpr std::size_t MinDescriptionWidth{ 20 };
+
+
+/** \brief The width descriptions are wrapped at so that, indented by
+           \a indentation then four more, they fit in \a lineWidth columns.
+ */
+inline std::size_t descriptionWidth( std::size_t lineWidth, unsigned int indentation )
+{
+  const std::size_t Indent{ indentation + 4u };
+  return lineWidth > Indent + MinDescriptionWidth ? lineWidth - Indent : MinDescriptionWidth;
+}
+
+
+/** \brief Append the usage of every option in \a options to \a out, in the
+           order they were defined, to fit \a lineWidth columns. See
+           appendOption.
+ */
+template< class Key, class Hash >
+void appendUsage( std::string& out
+                , const Options<Key, Hash>& options
+                , std::size_t lineWidth
+                , unsigned int indentation = 4 )
+{
+  const std::size_t Width{ descriptionWidth( lineWidth, indentation ) };
+  for ( std::size_t slot = 0; slot < options.size(); ++slot )
+  {
+    appendOption( out, options.definitionAt( slot ).option, indentation, Width );
+  }
+}
+
+
+/** \brief Write the usage of every option in \a options to \a os in one go.
+
+    It is rendered to fit \a lineWidth columns or, if that is 0, the terminal
+    on standard output (see terminalWidth). For help that may be asked for
+    more than once use a UsageCache.
+ */
+template< class Key, class Hash >
+void printUsage( std::ostream& os
+               , const Options<Key, Hash>& options
+               , std::size_t lineWidth = 0
+               , unsigned int indentation = 4 )
+{
+  std::string out;
+  appendUsage( out, options, lineWidth ? lineWidth : terminalWidth( STDOUT_FILENO ), indentation );
+  os.write( out.data(), out.size() );
+}
+
+
+/** \brief The usage of an Options instance, rendered once for each width it
+           is asked for.
+
+    The \a options must outlive the cache and not be changed while it is in
+    use. A cache is not safe to use from several threads at once.
+ */
+template< class Key, class Hash = std::hash<Key> >
+class UsageCache
+{
+public:
+  explicit UsageCache( const Options<Key, Hash>& o, unsigned int indentation = 4 )
+    : options{ o }, indentation{ indentation } {}
+
+  /** \brief The usage to fit \a lineWidth columns, 0 for the terminal. */
+  const std::string& get( std::size_t lineWidth = 0 )
+  {
+    if ( lineWidth == 0 )
+    {
+      lineWidth = terminalWidth( STDOUT_FILENO );
+    }
+    auto [i, isNew]{ rendered.try_emplace( lineWidth ) };
+    if ( isNew )
+    {
+      appendUsage( i->second, options, lineWidth, indentation );
+    }
+    return i->second;
+  }
+
+  /** \brief Write the usage to fit \a lineWidth columns to \a os. */
+  void print( std::ostream& os, std::size_t lineWidth = 0 )
+  {
+    const auto& usage{ get( lineWidth ) };
+    os.write( usage.data(), usage.size() );
+  }
+
+private:
+  const Options<Key, Hash>& options;
+  const unsigned int indentation;
+  std::map<std::size_t, std::string> rendered;
+};
+
+
+} // End of namespace options
+
+
+} // End of namespace lb
+
+
+#endif // LIB_LB_OPTIONS_USAGE_H
@@ -28,7 +28,10 @@
     For more information, please refer to <https://unlicense.org>
 */
 
+#include <cstddef>
 #include <iosfwd>
+#include <string>
+#include <string_view>
 
 
 namespace lb
@@ -39,7 +42,52 @@ namespace options
 {
 
 class OptionDefinition;
-void print( std::ostream&, const OptionDefinition&, unsigned int indentation );
+
+/** \brief The width descriptions are wrapped at by default. */
+constexpr std::size_t DefaultDescriptionWidth{ 64 };
+
+/** \brief Write the usage of \a option to \a os, see appendOption. */
+void print( std::ostream&
+          , const OptionDefinition&
+          , unsigned int indentation
+          , std::size_t width = DefaultDescriptionWidth );
+
+/** \brief Append the usage of \a option to \a out: its flags indented by
+           \a indentation then its description and defaults, indented a
+           further four and wrapped at \a width characters.
+
+    Nothing is allocated bar the growth of \a out.
+ */
+void appendOption( std::string& out
+                 , const OptionDefinition& option
+                 , unsigned int indentation
+                 , std::size_t width = DefaultDescriptionWidth );
+
+/** \brief Word wrap \a str at \a width characters onto \a os, prefixing each
+           line with \a indent (bar the first if \a skipInitialIndent).
+ */
+void split( std::ostream&
+          , std::string_view str
+          , std::string_view indent
+          , bool skipInitialIndent
+          , std::size_t width );
+
+/** \brief As split but appending to \a out, without any temporaries.
+
+    A line is broken at the last space that fits, or at \a width if there is
+    none, and a newline in \a str starts a new paragraph after a blank line.
+    A \a width of zero is taken as one.
+ */
+void appendWrapped( std::string& out
+                  , std::string_view str
+                  , std::string_view indent
+                  , bool skipInitialIndent
+                  , std::size_t width );
+
+/** \brief The number of columns of the terminal open on \a fd, else of the
+           COLUMNS environment variable, else 80.
+ */
+std::size_t terminalWidth( int fd );
 
 
 } // End of namespace options
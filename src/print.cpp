@@ -27,8 +27,13 @@
 
 #include <lb/options/print.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
+#include <sys/ioctl.h>
+#include <unistd.h>
+
 #include <lb/options/OptionDefinition.h>
 
 
@@ -40,23 +45,45 @@ namespace options
 {
 
 
-void split( std::ostream& os
-          , const std::string& str
-          , const std::string& indent
-          , bool skipInitialIndent
-          , std::string::size_type width )
+namespace
+{
+
+
+// A run of \a n spaces, for indents, from a buffer kept per thread.
+std::string_view spaces( std::size_t n )
+{
+  thread_local std::string buffer;
+  if ( buffer.size() < n )
+  {
+    buffer.assign( n, ' ' );
+  }
+  return std::string_view{ buffer }.substr( 0, n );
+}
+
+
+} // End of anonymous namespace
+
+
+void appendWrapped( std::string& out
+                  , std::string_view str
+                  , std::string_view indent
+                  , bool skipInitialIndent
+                  , std::size_t width )
 {
-  std::string::size_type i = 0;
+  // Every line takes at least one character, else this would never finish.
+  width = std::max<std::size_t>( width, 1 );
+
+  std::string_view::size_type i = 0;
   while ( i < str.size() )
   {
     // The line to print out. Might be less if we go back to the last space or
     // the first newline.
     auto s{ str.substr( i, width ) };
 
-    // First look for a newline cahracter to see if we should start a new
+    // First look for a newline character to see if we should start a new
     // paragraph.
     const auto firstNewline{ s.find_first_of( '\n' ) };
-    const bool newParagraph{ firstNewline != std::string::npos };
+    const bool newParagraph{ firstNewline != std::string_view::npos };
     if ( newParagraph )
     {
       s = s.substr( 0, firstNewline );
@@ -67,7 +94,7 @@ void split( std::ostream& os
       // Not the last line (unless there are zero characters after this). Split
       // the line at a sensible place.
       const auto lastSpace{ s.find_last_of( ' ' ) };
-      if ( lastSpace != std::string::npos )
+      if ( lastSpace != std::string_view::npos )
       {
         s = s.substr( 0, lastSpace );
         ++i; // Skip the space for the next line.
@@ -80,55 +107,96 @@ void split( std::ostream& os
     }
     else
     {
-      os << indent;
-    }
-    os << s << '\n';
-    if ( newParagraph )
-    {
-      os << '\n';
+      out.append( indent );
     }
+    out.append( s ).append( newParagraph ? 2 : 1, '\n' );
     i += s.size();
   }
 }
 
-void print( std::ostream& os, const OptionDefinition& option, unsigned int indentation )
+void split( std::ostream& os
+          , std::string_view str
+          , std::string_view indent
+          , bool skipInitialIndent
+          , std::size_t width )
+{
+  // Wrapped into a buffer kept per thread then written in one go.
+  thread_local std::string out;
+  out.clear();
+  appendWrapped( out, str, indent, skipInitialIndent, width );
+  os.write( out.data(), out.size() );
+}
+
+void appendOption( std::string& out
+                 , const OptionDefinition& option
+                 , unsigned int indentation
+                 , std::size_t width )
 {
-  const std::string indent1( indentation, ' ' );
-  const std::string indent2( indent1 + "    " );
-  os << indent1;
+  const std::size_t Indent1{ indentation };
+  const std::size_t Indent2{ Indent1 + 4 };
+  out.append( Indent1, ' ' );
   if ( option.s != '\0' )
   {
-    os << '-' << option.s;
+    out.append( 1, '-' ).append( 1, option.s );
   }
   if ( !option.l.empty() )
   {
     if ( option.s != '\0' )
     {
-      os << ", ";
+      out.append( ", " );
     }
-    os << "--" << option.l;
+    out.append( "--" ).append( option.l );
   }
-  os << '\n';
+  out.append( 1, '\n' );
 
-  const std::string::size_type width{ 64 };
-  split( os, option.description, indent2, false, width );
+  appendWrapped( out, option.description, spaces( Indent2 ), false, width );
 
   if ( !option.defaultValues.empty() )
   {
     if ( !option.description.empty() )
     {
-      os << '\n';
+      out.append( 1, '\n' );
     }
-    const std::string defaults{ "Default: " };
-    os << indent2 << defaults;
-    const std::string indent3{ indent2 + std::string( defaults.size(), ' ' ) };
-    std::string str;
+    constexpr std::string_view Defaults{ "Defaults: " };
+    out.append( Indent2, ' ' ).append( Defaults );
+
+    // Wrapped as one space separated string, joined in a buffer kept per
+    // thread so that it only allocates when it has to grow.
+    thread_local std::string joined;
+    joined.clear();
     for ( const auto& dv : option.defaultValues )
     {
-      str += dv + ' ';
+      joined.append( dv ).append( 1, ' ' );
+    }
+    appendWrapped( out, joined, spaces( Indent2 + Defaults.size() ), true
+                 , width > Defaults.size() ? width - Defaults.size() : 1 );
+  }
+}
+
+void print( std::ostream& os, const OptionDefinition& option, unsigned int indentation, std::size_t width )
+{
+  thread_local std::string out;
+  out.clear();
+  appendOption( out, option, indentation, width );
+  os.write( out.data(), out.size() );
+}
+
+std::size_t terminalWidth( int fd )
+{
+  winsize size{};
+  if ( ( ioctl( fd, TIOCGWINSZ, &size ) == 0 ) && ( size.ws_col > 0 ) )
+  {
+    return size.ws_col;
+  }
+  if ( const char* const columns{ std::getenv( "COLUMNS" ) } )
+  {
+    const long value{ std::strtol( columns, nullptr, 10 ) };
+    if ( value > 0 )
+    {
+      return static_cast<std::size_t>( value );
     }
-    split( os, str, indent3, true, width - defaults.size() );
   }
+  return 80;
 }
 
 